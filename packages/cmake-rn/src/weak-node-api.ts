@@ -42,7 +42,12 @@ export function getWeakNodeApiPath(triplet: SupportedTriplet): string {
 }
 
 export function getWeakNodeApiVariables(triplet: SupportedTriplet) {
-  const includePaths = [getNodeApiHeadersPath(), getNodeAddonHeadersPath()];
+  const includePaths = [
+    getNodeApiHeadersPath(),
+    getNodeAddonHeadersPath(),
+    // Declares the extensions of Node-API implemented by the host
+    weakNodeApiPath,
+  ];
   for (const includePath of includePaths) {
     assert(
       !includePath.includes(";"),
@@ -2,12 +2,15 @@
 
 #include <ReactCommon/CxxTurboModuleUtils.h>
 
+#include <AddonPreloader.hpp>
 #include <CxxNodeApiHostModule.hpp>
 #include <WeakNodeApiInjector.hpp>
 
 // Called when the library is loaded
 jint JNI_OnLoad(JavaVM *vm, void *reserved) {
   callstack::nodeapihost::injectIntoWeakNodeApi();
+  // Start loading addons while the app is still starting up
+  callstack::nodeapihost::preloadLinkedNodeAddons();
   // Register the C++ TurboModule
   facebook::react::registerCxxModuleToGlobalModuleMap(
       callstack::nodeapihost::CxxNodeApiHostModule::kModuleName,
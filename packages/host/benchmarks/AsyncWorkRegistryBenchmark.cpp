@@ -0,0 +1,204 @@
+// Compares the throughput of creating, queueing and deleting async work with
+// the slab based `AsyncWorkRegistry` against the previous registry, which kept
+// heap allocated jobs in an `std::unordered_map` of `std::shared_ptr`.
+//
+// "Queueing" only covers the registry's share of `napi_queue_async_work`: The
+// handle lookup and the state transition, not the hop to the thread pool.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "AsyncWorkRegistry.hpp"
+
+namespace {
+
+namespace legacy {
+struct AsyncJob {
+  using IdType = uint64_t;
+  enum State { Created, Queued, Running, Completed, Cancelled, Deleted };
+
+  IdType id{};
+  std::atomic<State> state{};
+  napi_env env;
+  napi_value async_resource;
+  napi_value async_resource_name;
+  napi_async_execute_callback execute;
+  napi_async_complete_callback complete;
+  void* data{nullptr};
+
+  static AsyncJob* fromWork(napi_async_work work) {
+    return reinterpret_cast<AsyncJob*>(work);
+  }
+  static napi_async_work toWork(AsyncJob* job) {
+    return reinterpret_cast<napi_async_work>(job);
+  }
+};
+
+class AsyncWorkRegistry {
+ public:
+  using IdType = AsyncJob::IdType;
+
+  std::shared_ptr<AsyncJob> create(napi_env env,
+      napi_value async_resource,
+      napi_value async_resource_name,
+      napi_async_execute_callback execute,
+      napi_async_complete_callback complete,
+      void* data) {
+    const auto job = std::shared_ptr<AsyncJob>(new AsyncJob{
+        .id = next_id(),
+        .state = AsyncJob::State::Created,
+        .env = env,
+        .async_resource = async_resource,
+        .async_resource_name = async_resource_name,
+        .execute = execute,
+        .complete = complete,
+        .data = data,
+    });
+
+    jobs_[job->id] = job;
+    return job;
+  }
+
+  std::shared_ptr<AsyncJob> get(napi_async_work work) const {
+    const auto job = AsyncJob::fromWork(work);
+    if (!job) {
+      return {};
+    }
+    if (const auto it = jobs_.find(job->id); it != jobs_.end()) {
+      return it->second;
+    }
+    return {};
+  }
+
+  bool release(IdType id) {
+    if (const auto it = jobs_.find(id); it != jobs_.end()) {
+      it->second->state = AsyncJob::State::Deleted;
+      jobs_.erase(it);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  IdType next_id() {
+    if (current_id_ == std::numeric_limits<IdType>::max()) [[unlikely]] {
+      current_id_ = 0;
+    }
+    return ++current_id_;
+  }
+
+  IdType current_id_{0};
+  std::unordered_map<IdType, std::shared_ptr<AsyncJob>> jobs_;
+};
+}  // namespace legacy
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t JobsPerRound = 10000;
+constexpr size_t Rounds = 200;
+
+struct Timings {
+  Clock::duration create{};
+  Clock::duration queue{};
+  Clock::duration remove{};
+};
+
+void execute(napi_env, void*) {}
+void complete(napi_env, napi_status, void*) {}
+
+// Keeps the compiler from optimizing away lookups
+volatile uintptr_t sink;
+
+Timings benchmarkLegacy() {
+  legacy::AsyncWorkRegistry registry;
+  std::vector<napi_async_work> works(JobsPerRound);
+  Timings timings;
+  for (size_t round = 0; round < Rounds; round++) {
+    auto start = Clock::now();
+    for (auto& work : works) {
+      const auto job = registry.create(
+          nullptr, nullptr, nullptr, execute, complete, nullptr);
+      work = legacy::AsyncJob::toWork(job.get());
+    }
+    timings.create += Clock::now() - start;
+
+    start = Clock::now();
+    for (const auto work : works) {
+      if (const auto job = registry.get(work)) {
+        job->state = legacy::AsyncJob::State::Queued;
+        sink = reinterpret_cast<uintptr_t>(job.get());
+      }
+    }
+    timings.queue += Clock::now() - start;
+
+    start = Clock::now();
+    for (const auto work : works) {
+      if (const auto job = registry.get(work)) {
+        registry.release(job->id);
+      }
+    }
+    timings.remove += Clock::now() - start;
+  }
+  return timings;
+}
+
+Timings benchmarkSlab() {
+  callstack::nodeapihost::AsyncWorkRegistry registry;
+  std::vector<napi_async_work> works(JobsPerRound);
+  Timings timings;
+  for (size_t round = 0; round < Rounds; round++) {
+    auto start = Clock::now();
+    for (auto& work : works) {
+      work = registry.create(
+          nullptr, nullptr, nullptr, execute, complete, nullptr);
+    }
+    timings.create += Clock::now() - start;
+
+    start = Clock::now();
+    for (const auto work : works) {
+      if (const auto job = registry.get(work)) {
+        job->state = callstack::nodeapihost::AsyncJob::State::Queued;
+        sink = reinterpret_cast<uintptr_t>(job);
+      }
+    }
+    timings.queue += Clock::now() - start;
+
+    start = Clock::now();
+    for (const auto work : works) {
+      registry.release(work);
+    }
+    timings.remove += Clock::now() - start;
+  }
+  return timings;
+}
+
+double nanosPerOp(Clock::duration duration) {
+  return std::chrono::duration<double, std::nano>(duration).count() /
+         (JobsPerRound * Rounds);
+}
+
+void print(const char* name, const Timings& timings) {
+  std::printf("%-8s %10.1f %10.1f %10.1f\n",
+      name,
+      nanosPerOp(timings.create),
+      nanosPerOp(timings.queue),
+      nanosPerOp(timings.remove));
+}
+
+}  // namespace
+
+int main() {
+  // Warm up allocators and caches before measuring
+  benchmarkLegacy();
+  benchmarkSlab();
+
+  std::printf("%zu rounds of %zu jobs, in ns per job\n", Rounds, JobsPerRound);
+  std::printf("%-8s %10s %10s %10s\n", "registry", "create", "queue", "delete");
+  print("legacy", benchmarkLegacy());
+  print("slab", benchmarkSlab());
+  return 0;
+}
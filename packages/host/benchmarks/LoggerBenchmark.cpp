@@ -0,0 +1,82 @@
+// Measures the cost of a logging call on the calling thread, per level:
+// - Debug messages are compiled out of release builds (the default here).
+// - Warnings are formatted into the ring buffer, written by another thread.
+// - Errors are written before returning.
+// The previous logger, writing every message synchronously, is included for
+// comparison. Messages are written to /dev/null, so the numbers don't depend
+// on the terminal.
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include "Logger.hpp"
+
+namespace {
+
+namespace legacy {
+void log_warning(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  fprintf(stdout, "[%s] [NodeApiHost] ", "WARNING");
+  vfprintf(stdout, format, args);
+  fprintf(stdout, "\n");
+  va_end(args);
+}
+}  // namespace legacy
+
+using Clock = std::chrono::steady_clock;
+
+// Calls per round stay below the capacity of the ring buffer, which is
+// flushed between rounds, to measure the calls rather than the writes
+constexpr size_t CallsPerRound = 128;
+constexpr size_t Rounds = 2000;
+
+template <typename Log>
+double nanosPerCall(Log log) {
+  Clock::duration total{};
+  for (size_t round = 0; round < Rounds; round++) {
+    const auto start = Clock::now();
+    for (size_t i = 0; i < CallsPerRound; i++) {
+      log(i);
+    }
+    total += Clock::now() - start;
+    callstack::nodeapihost::flush_logs();
+  }
+  return std::chrono::duration<double, std::nano>(total).count() /
+         (CallsPerRound * Rounds);
+}
+
+void print(const char* name, double nanos) {
+  std::fprintf(stderr, "%-24s %10.1f\n", name, nanos);
+}
+
+}  // namespace
+
+int main() {
+  if (!std::freopen("/dev/null", "w", stdout)) {
+    std::perror("Failed to redirect stdout");
+    return 1;
+  }
+
+  using namespace callstack::nodeapihost;
+  const auto debug = [](size_t i) { log_debug("Debug message %zu", i); };
+  const auto warning = [](size_t i) { log_warning("Warning message %zu", i); };
+  const auto error = [](size_t i) { log_error("Error message %zu", i); };
+  const auto legacyWarning = [](size_t i) {
+    legacy::log_warning("Warning message %zu", i);
+  };
+
+  // Warm up the logger thread and caches before measuring
+  nanosPerCall(warning);
+
+  std::fprintf(stderr,
+      "%zu rounds of %zu calls, minimum level %d, in ns per call\n",
+      Rounds,
+      CallsPerRound,
+      NODE_API_HOST_MIN_LOG_LEVEL);
+  print("log_debug", nanosPerCall(debug));
+  print("log_warning", nanosPerCall(warning));
+  print("log_error", nanosPerCall(error));
+  print("legacy log_warning", nanosPerCall(legacyWarning));
+  return 0;
+}
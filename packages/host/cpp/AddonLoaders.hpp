@@ -3,7 +3,7 @@
 
 #include <assert.h>
 
-#if defined(__APPLE__) || defined(__ANDROID__)
+#if defined(__APPLE__) || defined(__ANDROID__) || defined(__linux__)
 #include <dlfcn.h>
 #include <stdio.h>
 
@@ -16,12 +16,7 @@ struct PosixLoader {
   static Module loadLibrary(const char *filePath) {
     assert(NULL != filePath);
 
-    Module result = dlopen(filePath, RTLD_NOW | RTLD_LOCAL);
-    if (NULL == result) {
-      log_debug("NapiHost: Failed to load library '%s': %s", filePath,
-                dlerror());
-    }
-    return result;
+    return dlopen(filePath, RTLD_NOW | RTLD_LOCAL);
   }
 
   static Symbol getSymbol(Module library, const char *name) {
@@ -39,6 +34,12 @@ struct PosixLoader {
       dlclose(library);
     }
   }
+
+  // Describes why the last `loadLibrary` or `getSymbol` on this thread failed
+  static const char *getLastError() {
+    const char *error = dlerror();
+    return NULL != error ? error : "Unknown error";
+  }
 };
 #endif
 
@@ -0,0 +1,205 @@
+#include "AddonPreloader.hpp"
+#include <dlfcn.h>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "AddonLoaders.hpp"
+#include "Logger.hpp"
+#include "ThreadPool.hpp"
+#include "Tracing.hpp"
+
+// Written by `react-native-node-api link --preload`, listing the names of the
+// linked libraries as comma separated string literals
+#if defined(__APPLE__) && __has_include("../auto-linked/apple-preload.inc")
+#define HAS_LINKED_ADDONS_TO_PRELOAD 1
+#define LINKED_ADDONS_TO_PRELOAD "../auto-linked/apple-preload.inc"
+#elif defined(__ANDROID__) && \
+    __has_include("../auto-linked/android-preload.inc")
+#define HAS_LINKED_ADDONS_TO_PRELOAD 1
+#define LINKED_ADDONS_TO_PRELOAD "../auto-linked/android-preload.inc"
+#else
+#define HAS_LINKED_ADDONS_TO_PRELOAD 0
+#endif
+
+namespace callstack::nodeapihost {
+namespace {
+using LoaderPolicy = PosixLoader;
+
+// Dynamic linkers serialize much of `dlopen`, so a few tasks are enough to
+// overlap reading and relocating the libraries with the rest of the startup
+constexpr size_t MaxPreloadTasks = 4;
+
+// A library being preloaded, which is loaded by whichever of the preload task
+// and the first `requireNodeAddon` claims it first
+struct Preload {
+  std::atomic<bool> claimed{false};
+  std::promise<AddonLibrary> promise;
+  std::future<AddonLibrary> library{promise.get_future()};
+};
+
+std::mutex preloadsMutex;
+std::unordered_map<std::string, std::shared_ptr<Preload>> preloads;
+}  // namespace
+
+std::string getAddonLibraryPath(const std::string& libraryName) {
+#if defined(__APPLE__)
+  return "@rpath/" + libraryName + ".framework/" + libraryName;
+#elif defined(__ANDROID__)
+  return "lib" + libraryName + ".so";
+#elif defined(__linux__)
+  // Without an app bundle to look names up in, desktop builds accept paths
+  return libraryName.find('/') != std::string::npos
+             ? libraryName
+             : "lib" + libraryName + ".so";
+#else
+  abort();
+#endif
+}
+
+AddonLibrary loadAddonLibrary(const std::string& libraryName) {
+  const auto libraryPath = getAddonLibraryPath(libraryName);
+  log_debug("[%s] Loading addon by '%s'",
+      libraryName.c_str(),
+      libraryPath.c_str());
+
+  AddonLibrary result;
+  {
+    TraceScope trace{"dlopen", libraryName};
+    result.moduleHandle = LoaderPolicy::loadLibrary(libraryPath.c_str());
+  }
+  if (!result.moduleHandle) {
+    result.error = LoaderPolicy::getLastError();
+    log_error("[%s] Failed to load library: %s",
+        libraryName.c_str(),
+        result.error.c_str());
+    return result;
+  }
+  log_debug("[%s] Loaded addon", libraryName.c_str());
+
+  void* initFn = nullptr;
+  {
+    TraceScope trace{"dlsym", libraryName};
+    initFn = LoaderPolicy::getSymbol(
+        result.moduleHandle, "napi_register_module_v1");
+  }
+  if (initFn) {
+    log_debug("[%s] Found napi_register_module_v1 (%p)",
+        libraryName.c_str(),
+        initFn);
+    result.init = reinterpret_cast<napi_addon_register_func>(initFn);
+    if (Dl_info info; dladdr(initFn, &info) && info.dli_fname) {
+      result.filePath = info.dli_fname;
+    }
+  } else {
+    result.error = LoaderPolicy::getLastError();
+    log_error("[%s] Failed to find napi_register_module_v1: %s",
+        libraryName.c_str(),
+        result.error.c_str());
+    return result;
+  }
+
+  void* getApiVersionFn = LoaderPolicy::getSymbol(
+      result.moduleHandle, "node_api_module_get_api_version_v1");
+  if (getApiVersionFn) {
+    result.apiVersion = reinterpret_cast<int32_t (*)()>(getApiVersionFn)();
+  }
+  // Like Node.js, addons built against older versions get the default
+  // version, while addons requiring a newer version than the host
+  // implements aren't initialized
+  if (result.apiVersion < NODE_API_HOST_DEFAULT_MODULE_VERSION) {
+    result.apiVersion = NODE_API_HOST_DEFAULT_MODULE_VERSION;
+  } else if (result.apiVersion == NAPI_VERSION_EXPERIMENTAL) {
+    log_warning(
+        "[%s] Addon uses experimental Node-API features, which the host "
+        "doesn't implement beyond version %d",
+        libraryName.c_str(),
+        NAPI_VERSION);
+    result.apiVersion = NAPI_VERSION;
+  } else if (result.apiVersion > NAPI_VERSION) {
+    result.error = "Addon requires Node-API version " +
+                   std::to_string(result.apiVersion) +
+                   ", while the host implements up to version " +
+                   std::to_string(NAPI_VERSION);
+    log_error("[%s] %s", libraryName.c_str(), result.error.c_str());
+    result.init = nullptr;
+  }
+  log_debug("[%s] Using Node-API version %d",
+      libraryName.c_str(),
+      result.apiVersion);
+  return result;
+}
+
+void preloadNodeAddons(const std::vector<std::string>& libraryNames) {
+  using Pending =
+      std::vector<std::pair<std::string, std::shared_ptr<Preload>>>;
+  const auto pending = std::make_shared<Pending>();
+  {
+    std::lock_guard lock{preloadsMutex};
+    for (const auto& libraryName : libraryNames) {
+      if (preloads.contains(libraryName)) {
+        continue;
+      }
+      const auto& [name, preload] = pending->emplace_back(
+          libraryName, std::make_shared<Preload>());
+      preloads.emplace(name, preload);
+    }
+  }
+  if (pending->empty()) {
+    return;
+  }
+
+  // The tasks take turns picking the next library to load, on the threads
+  // executing async work. The first `requireNodeAddon` only waits for a
+  // library they started loading, and loads it itself otherwise.
+  const auto next = std::make_shared<std::atomic<size_t>>(0);
+  const auto taskCount = std::min(pending->size(), MaxPreloadTasks);
+  for (size_t i = 0; i < taskCount; i++) {
+    getThreadPool().submit(
+        [pending, next]() {
+          for (auto index = next->fetch_add(1); index < pending->size();
+               index = next->fetch_add(1)) {
+            const auto& [name, preload] = (*pending)[index];
+            if (!preload->claimed.exchange(true)) {
+              preload->promise.set_value(loadAddonLibrary(name));
+            }
+          }
+        },
+        TaskPriority::UserBlocking);
+  }
+}
+
+void preloadLinkedNodeAddons() {
+#if HAS_LINKED_ADDONS_TO_PRELOAD
+  preloadNodeAddons({
+#include LINKED_ADDONS_TO_PRELOAD
+  });
+#endif
+}
+
+AddonLibrary takeAddonLibrary(const std::string& libraryName) {
+  std::shared_ptr<Preload> preload;
+  {
+    std::lock_guard lock{preloadsMutex};
+    if (const auto it = preloads.find(libraryName); it != preloads.end()) {
+      preload = std::move(it->second);
+      preloads.erase(it);
+    }
+  }
+  // Rather than waiting for the preload task to get its turn on the pool
+  if (!preload || !preload->claimed.exchange(true)) {
+    return loadAddonLibrary(libraryName);
+  }
+  log_debug("[%s] Waiting for the preloaded addon", libraryName.c_str());
+  TraceScope trace{"waitForPreload", libraryName};
+  return preload->library.get();
+}
+
+void closeAddonLibrary(void* moduleHandle) {
+  LoaderPolicy::unloadLibrary(moduleHandle);
+}
+
+}  // namespace callstack::nodeapihost
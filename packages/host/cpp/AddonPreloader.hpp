@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Versions.hpp"
+#include "node_api.h"
+
+namespace callstack::nodeapihost {
+
+struct AddonLibrary {
+  void* moduleHandle{nullptr};
+  // Null if the addon doesn't export "napi_register_module_v1"
+  napi_addon_register_func init{nullptr};
+  // The absolute path of the loaded library, as resolved by the linker
+  std::string filePath;
+  // The Node-API version declared by the addon, to create its envs with
+  int32_t apiVersion{NODE_API_HOST_DEFAULT_MODULE_VERSION};
+  // Why the addon can't be initialized, if the register function is null
+  std::string error;
+};
+
+// Returns the path the library of an addon is loaded from on this platform
+std::string getAddonLibraryPath(const std::string& libraryName);
+
+// Loads the library of an addon and resolves its register function and
+// Node-API version, leaving the module handle null if the library failed to
+// load and the register function null if the addon can't be initialized
+AddonLibrary loadAddonLibrary(const std::string& libraryName);
+
+// Starts loading the libraries of addons on background threads, ahead of the
+// first `requireNodeAddon`, which then only has to initialize them.
+// Addons that are already being preloaded are skipped.
+void preloadNodeAddons(const std::vector<std::string>& libraryNames);
+
+// Preloads the addons linked with `react-native-node-api link --preload`
+void preloadLinkedNodeAddons();
+
+// Returns the library of an addon passed to `preloadNodeAddons`, waiting for it
+// to finish loading, or loads it on the calling thread if it wasn't preloaded
+// or its preload hasn't started yet
+AddonLibrary takeAddonLibrary(const std::string& libraryName);
+
+// Closes a library taken by `takeAddonLibrary` which no addon was initialized
+// from, such as when it was loaded twice. Libraries of initialized addons are
+// never closed, as the runtimes they were initialized in might call into them
+// until destroyed, such as to finalize objects, while the host can't tell
+// when that's done.
+void closeAddonLibrary(void* moduleHandle);
+
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "ThreadPool.hpp"
+#include "Versions.hpp"
+#include "node_api.h"
+
+namespace facebook::react {
+class CallInvoker;
+}
+
+namespace callstack::nodeapihost {
+
+struct AsyncJob {
+  enum State {
+    Created,
+    Queued,
+    Running,
+    Executed,
+    Completed,
+    Cancelled,
+    Deleted
+  };
+
+  // Written from both the JS thread and the worker executing the job. Slots
+  // not in use are Deleted.
+  std::atomic<State> state{State::Deleted};
+  // Atomic to let envs being torn down look for their jobs among all jobs
+  std::atomic<napi_env> env{};
+  napi_value async_resource{};
+  napi_value async_resource_name{};
+  napi_async_execute_callback execute{};
+  napi_async_complete_callback complete{};
+  void* data{nullptr};
+  // Only accessed from the JS thread. The priority might change while queued,
+  // taking effect when queued next, so the task is found by the priority it
+  // was queued with.
+  TaskPriority priority{TaskPriority::Default};
+  TaskPriority queuedPriority{TaskPriority::Default};
+  ThreadPool::TaskId taskId{0};
+  // Captured when queued, as the worker completes the job through it
+  std::weak_ptr<facebook::react::CallInvoker> invoker;
+};
+
+/**
+ * Owns the async jobs of all envs in a slab of fixed-size chunks, which are
+ * never moved or freed, recycling released slots through a lock-free free
+ * list. A `napi_async_work` handle encodes the index of its slot and the
+ * generation of the slot at the time of creation: Looking up a handle is a
+ * couple of loads without locking or hashing, and handles to released jobs
+ * are detected by their outdated generation instead of dangling. Slots are
+ * only reused once unpinned, such as by the tasks executing their jobs.
+ *
+ * Only growing the slab by another chunk takes a lock.
+ */
+class AsyncWorkRegistry {
+ public:
+  static constexpr uint32_t ChunkSize = 256;
+  static constexpr uint32_t MaxChunks = 4096;
+
+  AsyncWorkRegistry() = default;
+  ~AsyncWorkRegistry() {
+    for (auto& chunk : chunks_) {
+      delete[] chunk.load(std::memory_order_relaxed);
+    }
+  }
+
+  AsyncWorkRegistry(const AsyncWorkRegistry&) = delete;
+  AsyncWorkRegistry& operator=(const AsyncWorkRegistry&) = delete;
+
+  // Returns nullptr if the registry is exhausted
+  napi_async_work create(napi_env env,
+      napi_value async_resource,
+      napi_value async_resource_name,
+      napi_async_execute_callback execute,
+      napi_async_complete_callback complete,
+      void* data) {
+    uint32_t index;
+    if (!popFree(index) && !grow(index)) {
+      return nullptr;
+    }
+    Slot& slot = slotAt(index);
+    AsyncJob& job = slot.job;
+    slot.pins.store(1, std::memory_order_relaxed);
+    job.state.store(AsyncJob::State::Created, std::memory_order_relaxed);
+    job.env = env;
+    job.async_resource = async_resource;
+    job.async_resource_name = async_resource_name;
+    job.execute = execute;
+    job.complete = complete;
+    job.data = data;
+    job.priority = TaskPriority::Default;
+    job.queuedPriority = TaskPriority::Default;
+    job.invoker.reset();
+    return encode(index, slot.generation.load(std::memory_order_acquire));
+  }
+
+  // Returns nullptr for handles which were never created or since released
+  AsyncJob* get(napi_async_work work) const {
+    const auto handle = reinterpret_cast<uintptr_t>(work);
+    const auto index = static_cast<uint32_t>(handle & IndexMask);
+    const auto generation = static_cast<uint32_t>(handle >> IndexBits);
+    if (generation == 0 || index >= ChunkSize * MaxChunks) {
+      return nullptr;
+    }
+    Slot* chunk = chunks_[index / ChunkSize].load(std::memory_order_acquire);
+    if (!chunk) {
+      return nullptr;
+    }
+    Slot& slot = chunk[index % ChunkSize];
+    if (slot.generation.load(std::memory_order_acquire) != generation) {
+      return nullptr;
+    }
+    return &slot.job;
+  }
+
+  bool release(napi_async_work work) {
+    if (!get(work)) {
+      return false;
+    }
+    const auto index = indexOf(work);
+    Slot& slot = slotAt(index);
+    slot.job.state.store(AsyncJob::State::Deleted, std::memory_order_relaxed);
+    slot.job.state.notify_all();
+    slot.job.invoker.reset();
+    // Invalidates outstanding handles before the slot can be reused
+    auto generation = slot.generation.load(std::memory_order_relaxed);
+    generation = (generation + 1) & GenerationMask;
+    slot.generation.store(
+        generation ? generation : 1, std::memory_order_release);
+    unpin(index);
+    return true;
+  }
+
+  // Keeps the slot of a job from being reused until unpinned, even once the
+  // job is released: A task holding on to the job while queued then finds it
+  // released instead of replaced by another job. Returns nullptr for handles
+  // which were never created or since released.
+  AsyncJob* pin(napi_async_work work) {
+    const auto job = get(work);
+    if (job) {
+      slotAt(indexOf(work)).pins.fetch_add(1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  void unpin(napi_async_work work) { unpin(indexOf(work)); }
+
+  // Calls `visit` with the handle and job of every slot in use, such as to
+  // find the jobs of an env being torn down. Jobs of other envs might be
+  // created or released meanwhile.
+  template <typename Visit>
+  void forEach(Visit&& visit) {
+    for (uint32_t chunkIndex = 0; chunkIndex < MaxChunks; chunkIndex++) {
+      Slot* chunk = chunks_[chunkIndex].load(std::memory_order_acquire);
+      if (!chunk) {
+        return;
+      }
+      for (uint32_t i = 0; i < ChunkSize; i++) {
+        Slot& slot = chunk[i];
+        if (slot.job.state.load(std::memory_order_acquire) ==
+            AsyncJob::State::Deleted) {
+          continue;
+        }
+        visit(encode(chunkIndex * ChunkSize + i,
+                  slot.generation.load(std::memory_order_acquire)),
+            slot.job);
+      }
+    }
+  }
+
+ private:
+  // Handles must fit a pointer, which leaves fewer generation bits on 32-bit
+  static constexpr unsigned IndexBits = sizeof(uintptr_t) == 8 ? 32 : 20;
+  static constexpr uintptr_t IndexMask = (uintptr_t{1} << IndexBits) - 1;
+  static constexpr uint32_t GenerationMask = static_cast<uint32_t>(
+      (uintptr_t{1} << (sizeof(uintptr_t) * 8 - IndexBits)) - 1);
+  static_assert(ChunkSize * MaxChunks <= IndexMask);
+
+  // Marks the end of the free list
+  static constexpr uint32_t NoIndex = UINT32_MAX;
+
+  struct Slot {
+    // Starts at 1, leaving 0 to tell null handles apart
+    std::atomic<uint32_t> generation{1};
+    std::atomic<uint32_t> nextFree{NoIndex};
+    // Held by the handle until released, and by whoever pinned the slot
+    std::atomic<uint32_t> pins{0};
+    AsyncJob job;
+  };
+
+  static uint32_t indexOf(napi_async_work work) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(work) & IndexMask);
+  }
+
+  static napi_async_work encode(uint32_t index, uint32_t generation) {
+    return reinterpret_cast<napi_async_work>(
+        (static_cast<uintptr_t>(generation) << IndexBits) | index);
+  }
+
+  Slot& slotAt(uint32_t index) const {
+    return chunks_[index / ChunkSize].load(
+        std::memory_order_acquire)[index % ChunkSize];
+  }
+
+  // The last to let go of a slot frees it
+  void unpin(uint32_t index) {
+    if (slotAt(index).pins.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      pushFree(index);
+    }
+  }
+
+  // The head of the free list is tagged with a counter, bumped on every
+  // update, to avoid the ABA problem of a Treiber stack
+  static uint64_t packHead(uint32_t index, uint32_t tag) {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+  }
+
+  bool popFree(uint32_t& index) {
+    auto head = freeHead_.load(std::memory_order_acquire);
+    while (true) {
+      const auto candidate = static_cast<uint32_t>(head);
+      if (candidate == NoIndex) {
+        return false;
+      }
+      const auto next =
+          slotAt(candidate).nextFree.load(std::memory_order_relaxed);
+      const auto tag = static_cast<uint32_t>(head >> 32) + 1;
+      if (freeHead_.compare_exchange_weak(head,
+              packHead(next, tag),
+              std::memory_order_acq_rel,
+              std::memory_order_acquire)) {
+        index = candidate;
+        return true;
+      }
+    }
+  }
+
+  void pushFree(uint32_t index) {
+    auto head = freeHead_.load(std::memory_order_relaxed);
+    while (true) {
+      slotAt(index).nextFree.store(
+          static_cast<uint32_t>(head), std::memory_order_relaxed);
+      const auto tag = static_cast<uint32_t>(head >> 32) + 1;
+      if (freeHead_.compare_exchange_weak(head,
+              packHead(index, tag),
+              std::memory_order_release,
+              std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  // Adds a chunk, handing out its first slot and freeing the rest
+  bool grow(uint32_t& index) {
+    std::lock_guard lock{growMutex_};
+    // Another thread might have grown the slab while waiting for the lock
+    if (popFree(index)) {
+      return true;
+    }
+    const auto chunkIndex = chunkCount_;
+    if (chunkIndex == MaxChunks) {
+      return false;
+    }
+    chunks_[chunkIndex].store(new Slot[ChunkSize], std::memory_order_release);
+    chunkCount_++;
+    const auto first = chunkIndex * ChunkSize;
+    for (uint32_t i = ChunkSize - 1; i > 0; i--) {
+      pushFree(first + i);
+    }
+    index = first;
+    return true;
+  }
+
+  std::array<std::atomic<Slot*>, MaxChunks> chunks_{};
+  uint32_t chunkCount_{0};  // Guarded by growMutex_
+  std::atomic<uint64_t> freeHead_{packHead(NoIndex, 0)};
+  std::mutex growMutex_;
+};
+
+}  // namespace callstack::nodeapihost
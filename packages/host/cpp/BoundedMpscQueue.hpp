@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace callstack::nodeapihost {
+
+/**
+ * A bounded, lock-free queue for many producer threads and a single consumer
+ * thread, based on Dmitry Vyukov's bounded MPMC queue: Each cell carries a
+ * sequence number telling producers and the consumer whose turn it is, so
+ * pushing is a single CAS on the enqueue position and popping needs no atomic
+ * read-modify-write at all.
+ */
+template <typename T>
+class BoundedMpscQueue {
+ public:
+  // The capacity is rounded up to the nearest power of two
+  explicit BoundedMpscQueue(size_t capacity)
+      : mask_(roundUpToPowerOfTwo(capacity) - 1),
+        cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+    for (size_t i = 0; i <= mask_; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+  BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+  // Safe to call from any thread. Returns false if the queue is full.
+  bool tryPush(T value) {
+    return tryPushWith(
+        [&value](T& cellValue) { cellValue = std::move(value); });
+  }
+
+  // Like `tryPush`, but calls `fill` to write the value into its cell in
+  // place, saving a copy of large values
+  template <typename Fill>
+  bool tryPushWith(Fill&& fill) {
+    auto position = enqueuePosition_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[position & mask_];
+      const auto sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (difference == 0) {
+        if (enqueuePosition_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueuePosition_.load(std::memory_order_relaxed);
+      }
+    }
+    fill(cell->value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Must only be called from the consumer thread. Returns false if empty.
+  bool tryPop(T& value) {
+    return tryConsume([&value](T& cellValue) { value = std::move(cellValue); });
+  }
+
+  // Like `tryPop`, but calls `consume` with the value in its cell, which is
+  // reused once `consume` returns
+  template <typename Consume>
+  bool tryConsume(Consume&& consume) {
+    Cell* cell = &cells_[dequeuePosition_ & mask_];
+    const auto sequence = cell->sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) -
+            static_cast<intptr_t>(dequeuePosition_ + 1) <
+        0) {
+      return false;
+    }
+    consume(cell->value);
+    cell->sequence.store(
+        dequeuePosition_ + mask_ + 1, std::memory_order_release);
+    dequeuePosition_++;
+    return true;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_t mask_;
+  const std::unique_ptr<Cell[]> cells_;
+  // Kept on separate cache lines to avoid false sharing between the threads
+  alignas(64) std::atomic<size_t> enqueuePosition_{0};
+  alignas(64) size_t dequeuePosition_{0};
+};
+
+}  // namespace callstack::nodeapihost
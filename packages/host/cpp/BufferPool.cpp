@@ -0,0 +1,198 @@
+#include "BufferPool.hpp"
+#include <memory>
+#include "Logger.hpp"
+#include "ReadMostlyMap.hpp"
+#include "RuntimeNodeApiLifecycle.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+// Slices start at multiples of this, like in Node.js, so the data of a pooled
+// buffer can be viewed by any typed array
+constexpr size_t PoolAlignment = 8;
+
+// Looked up without locking on every buffer an addon creates, while only
+// updated when an env creates its first buffer or goes away
+ReadMostlyMap<napi_env, std::shared_ptr<BufferPool>> pools;
+
+void removeBufferPool(void* arg) {
+  // The env is being torn down and releases the references on its own
+  pools.erase(static_cast<napi_env>(arg));
+}
+}  // namespace
+
+napi_status BufferPool::allocate(
+    size_t length, void** data, napi_value* result) {
+  if (length >= MaxPooledSize) {
+    void* bufferData = nullptr;
+    napi_value arraybuffer;
+    if (const auto status =
+            napi_create_arraybuffer(env_, length, &bufferData, &arraybuffer);
+        status != napi_ok) {
+      return status;
+    }
+    if (const auto status = createView(arraybuffer, 0, length, result);
+        status != napi_ok) {
+      return status;
+    }
+    if (data) {
+      *data = bufferData;
+    }
+    return napi_ok;
+  }
+
+  if (!pool_ || PoolSize - poolOffset_ < length) {
+    if (const auto status = createPool(); status != napi_ok) {
+      return status;
+    }
+  }
+
+  napi_value pool;
+  if (const auto status = napi_get_reference_value(env_, pool_, &pool);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status = createView(pool, poolOffset_, length, result);
+      status != napi_ok) {
+    return status;
+  }
+  if (data) {
+    *data = poolData_ + poolOffset_;
+  }
+
+  poolOffset_ += length;
+  if (const auto misalignment = poolOffset_ % PoolAlignment) {
+    poolOffset_ += PoolAlignment - misalignment;
+  }
+  return napi_ok;
+}
+
+napi_status BufferPool::wrap(
+    napi_value arraybuffer, size_t length, napi_value* result) {
+  return createView(arraybuffer, 0, length, result);
+}
+
+napi_status BufferPool::createPool() {
+  void* poolData = nullptr;
+  napi_value pool;
+  if (const auto status =
+          napi_create_arraybuffer(env_, PoolSize, &poolData, &pool);
+      status != napi_ok) {
+    return status;
+  }
+
+  // Buffers sliced out of the previous pool keep it alive
+  if (pool_) {
+    if (const auto status = napi_delete_reference(env_, pool_);
+        status != napi_ok) {
+      return status;
+    }
+    pool_ = nullptr;
+  }
+  if (const auto status = napi_create_reference(env_, pool, 1, &pool_);
+      status != napi_ok) {
+    return status;
+  }
+
+  poolData_ = static_cast<uint8_t*>(poolData);
+  poolOffset_ = 0;
+  return napi_ok;
+}
+
+napi_status BufferPool::createView(napi_value arraybuffer,
+    size_t offset,
+    size_t length,
+    napi_value* result) {
+  if (!bufferFromResolved_) {
+    if (const auto status = resolveBufferFrom(); status != napi_ok) {
+      return status;
+    }
+  }
+  if (!bufferFrom_) {
+    return napi_create_typedarray(
+        env_, napi_uint8_array, length, arraybuffer, offset, result);
+  }
+
+  napi_value buffer, bufferFrom;
+  napi_value argv[3] = {arraybuffer, nullptr, nullptr};
+  if (const auto status = napi_get_reference_value(env_, buffer_, &buffer);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status =
+          napi_get_reference_value(env_, bufferFrom_, &bufferFrom);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status =
+          napi_create_double(env_, static_cast<double>(offset), &argv[1]);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status =
+          napi_create_double(env_, static_cast<double>(length), &argv[2]);
+      status != napi_ok) {
+    return status;
+  }
+  return napi_call_function(env_, buffer, bufferFrom, 3, argv, result);
+}
+
+napi_status BufferPool::resolveBufferFrom() {
+  bufferFromResolved_ = true;
+
+  napi_value global;
+  if (const auto status = napi_get_global(env_, &global); status != napi_ok) {
+    return status;
+  }
+
+  napi_value buffer;
+  if (const auto status =
+          napi_get_named_property(env_, global, "Buffer", &buffer);
+      status != napi_ok) {
+    return status;
+  }
+  napi_valuetype type{};
+  if (const auto status = napi_typeof(env_, buffer, &type); status != napi_ok) {
+    return status;
+  }
+  if (type != napi_function) {
+    log_debug("No global Buffer, creating buffers as plain Uint8Arrays");
+    return napi_ok;
+  }
+
+  napi_value bufferFrom;
+  if (const auto status =
+          napi_get_named_property(env_, buffer, "from", &bufferFrom);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status = napi_typeof(env_, bufferFrom, &type);
+      status != napi_ok) {
+    return status;
+  }
+  if (type != napi_function) {
+    log_warning(
+        "The global Buffer has no from function, creating buffers as plain "
+        "Uint8Arrays");
+    return napi_ok;
+  }
+
+  if (const auto status = napi_create_reference(env_, buffer, 1, &buffer_);
+      status != napi_ok) {
+    return status;
+  }
+  return napi_create_reference(env_, bufferFrom, 1, &bufferFrom_);
+}
+
+BufferPool* getBufferPool(napi_env env) {
+  // The pool is only used and removed on the JS thread of the env, which
+  // keeps it alive after the lookup
+  if (const auto pool = pools.get(env)) {
+    return pool.get();
+  }
+  const auto pool = std::make_shared<BufferPool>(env);
+  pools.set(env, pool);
+  addHostCleanupHook(env, removeBufferPool, env);
+  return pool.get();
+}
+
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Versions.hpp"
+#include "node_api.h"
+
+namespace callstack::nodeapihost {
+
+/**
+ * Allocates the memory of Buffers for a single env, the way Node.js does:
+ * Small buffers are sliced out of a shared, pre-allocated ArrayBuffer (the
+ * "pool") instead of each getting an ArrayBuffer of their own, which keeps
+ * the number of objects the garbage collector tracks down when addons create
+ * many short-lived buffers.
+ *
+ * The returned buffers are plain Uint8Arrays, unless a global `Buffer` is
+ * installed (such as from a polyfill): Buffers are then created by its `from`
+ * as views of the pool, giving them its prototype. That takes a call into JS,
+ * but no ArrayBuffer of their own.
+ *
+ * Must only be used on the JS thread of the env.
+ */
+class BufferPool {
+ public:
+  // Matching `Buffer.poolSize` of Node.js
+  static constexpr size_t PoolSize = 8 * 1024;
+  // Buffers of at least this size get an ArrayBuffer of their own
+  static constexpr size_t MaxPooledSize = PoolSize >> 1;
+
+  explicit BufferPool(napi_env env) : env_(env) {}
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  // Creates a buffer of the given length, sliced out of the pool if small
+  napi_status allocate(size_t length, void** data, napi_value* result);
+
+  // Creates a buffer viewing the entire ArrayBuffer, without copying it
+  napi_status wrap(napi_value arraybuffer, size_t length, napi_value* result);
+
+ private:
+  napi_status createPool();
+  napi_status createView(napi_value arraybuffer,
+      size_t offset,
+      size_t length,
+      napi_value* result);
+  napi_status resolveBufferFrom();
+
+  napi_env env_;
+
+  // The current pool, referenced until it is exhausted: Buffers sliced out of
+  // it keep it alive for as long as they are.
+  napi_ref pool_{nullptr};
+  uint8_t* poolData_{nullptr};
+  size_t poolOffset_{0};
+
+  // `Buffer` and `Buffer.from` of the global `Buffer`, looked up once
+  bool bufferFromResolved_{false};
+  napi_ref buffer_{nullptr};
+  napi_ref bufferFrom_{nullptr};
+};
+
+// Returns the pool of the env, creating it on first use
+BufferPool* getBufferPool(napi_env env);
+
+}  // namespace callstack::nodeapihost
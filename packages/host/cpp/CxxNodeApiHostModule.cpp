@@ -1,18 +1,61 @@
 #include "CxxNodeApiHostModule.hpp"
+#include "AddonPreloader.hpp"
 #include "Logger.hpp"
+#include "RuntimeNodeApi.hpp"
 #include "RuntimeNodeApiAsync.hpp"
+#include "RuntimeNodeApiLifecycle.hpp"
+#include "ThreadPool.hpp"
+#include "Tracing.hpp"
+#include "weak_node_api_profiler.hpp"
 
 using namespace facebook;
 
 namespace callstack::nodeapihost {
 
+namespace {
+std::string getLoadErrorMessage(const std::string &libraryName,
+                                const AddonLibrary &library) {
+  return "Failed to load Node-API addon '" + libraryName +
+         "': " + library.error;
+}
+} // namespace
+
 CxxNodeApiHostModule::CxxNodeApiHostModule(
     std::shared_ptr<react::CallInvoker> jsInvoker)
     : TurboModule(CxxNodeApiHostModule::kModuleName, jsInvoker) {
   methodMap_["requireNodeAddon"] =
       MethodMetadata{1, &CxxNodeApiHostModule::requireNodeAddon};
+  methodMap_["requireNodeAddonAsync"] =
+      MethodMetadata{1, &CxxNodeApiHostModule::requireNodeAddonAsync};
+  methodMap_["getTraceEvents"] =
+      MethodMetadata{0, &CxxNodeApiHostModule::getTraceEvents};
+  methodMap_["getNodeApiProfile"] =
+      MethodMetadata{1, &CxxNodeApiHostModule::getNodeApiProfile};
 
   callInvoker_ = std::move(jsInvoker);
+  pendingLoads_ = std::make_shared<PendingLoads>();
+}
+
+CxxNodeApiHostModule::~CxxNodeApiHostModule() {
+  // The module is destroyed while its runtime is destroyed or afterwards, such
+  // as when reloading. The runtime tears the envs down when destroying them,
+  // so only the host's state of envs it won't tear down is released.
+  for (auto &[libraryName, addon] : nodeAddons_) {
+    for (napi_env env : addon.envs) {
+      forgetEnv(env);
+    }
+  }
+}
+
+void CxxNodeApiHostModule::invalidate() {
+  for (auto &[libraryName, addon] : nodeAddons_) {
+    for (napi_env env : addon.envs) {
+      TraceScope trace{"tearDownEnv", addon.libraryName};
+      tearDownEnv(env, addon.libraryName);
+    }
+    addon.envs.clear();
+    addon.exports.reset();
+  }
 }
 
 jsi::Value
@@ -23,8 +66,7 @@ CxxNodeApiHostModule::requireNodeAddon(jsi::Runtime &rt,
   if (1 == count && args[0].isString()) {
     return thisModule.requireNodeAddon(rt, args[0].asString(rt));
   }
-  // TODO: Throw a meaningful error
-  return jsi::Value::undefined();
+  throw jsi::JSError(rt, "Expected the library name of a Node-API addon");
 }
 
 jsi::Value
@@ -32,83 +74,255 @@ CxxNodeApiHostModule::requireNodeAddon(jsi::Runtime &rt,
                                        const jsi::String libraryName) {
   const std::string libraryNameStr = libraryName.utf8(rt);
 
-  auto [it, inserted] = nodeAddons_.emplace(libraryNameStr, NodeAddon());
+  auto [it, inserted] = nodeAddons_.try_emplace(libraryNameStr);
   NodeAddon &addon = it->second;
 
   // Check if this module has been loaded already, if not then load it...
+  // Preloaded addons are only waited for, others are loaded right away
   if (inserted) {
-    if (!loadNodeAddon(addon, libraryNameStr)) {
-      return jsi::Value::undefined();
+    TraceScope trace{"load", libraryNameStr};
+    const AddonLibrary library = takeAddonLibrary(libraryNameStr);
+    if (!loadNodeAddon(addon, libraryNameStr, library)) {
+      // Allows requiring the addon again, as nothing was loaded
+      nodeAddons_.erase(it);
+      throw jsi::JSError(rt, getLoadErrorMessage(libraryNameStr, library));
     }
   }
 
-  // Initialize the addon if it has not already been initialized
-  if (!rt.global().hasProperty(rt, addon.generatedName.data())) {
-    initializeNodeModule(rt, addon);
+  // Initialize the addon if it has not already been initialized, caching its
+  // exports
+  if (!addon.exports) {
+    TraceScope trace{"initialize", libraryNameStr};
+    jsi::Value error;
+    if (!initializeNodeModule(rt, addon, error)) {
+      if (!error.isUndefined()) {
+        throw jsi::JSError(rt, std::move(error));
+      }
+      throw jsi::JSError(rt, "Failed to initialize Node-API addon '" +
+                                 libraryNameStr + "'");
+    }
   }
 
-  // Look the exports up (using JSI) and return it...
-  return rt.global().getProperty(rt, addon.generatedName.data());
+  return jsi::Value(rt, *addon.exports);
 }
 
-bool CxxNodeApiHostModule::loadNodeAddon(NodeAddon &addon,
-                                         const std::string &libraryName) const {
-#if defined(__APPLE__)
-  std::string libraryPath =
-      "@rpath/" + libraryName + ".framework/" + libraryName;
-#elif defined(__ANDROID__)
-  std::string libraryPath = "lib" + libraryName + ".so";
-#else
-  abort()
-#endif
-
-  log_debug("[%s] Loading addon by '%s'", libraryName.c_str(),
-            libraryPath.c_str());
-
-  typename LoaderPolicy::Symbol initFn = NULL;
-  typename LoaderPolicy::Module library =
-      LoaderPolicy::loadLibrary(libraryPath.c_str());
-  if (NULL != library) {
-    log_debug("[%s] Loaded addon", libraryName.c_str());
-    addon.moduleHandle = library;
-
-    // Generate a name allowing us to reference the exports object from JSI
-    // later Instead of using random numbers to avoid name clashes, we just use
-    // the pointer address of the loaded module
-    addon.generatedName.resize(32, '\0');
-    snprintf(addon.generatedName.data(), addon.generatedName.size(),
-             "RN$NodeAddon_%p", addon.moduleHandle);
-
-    initFn = LoaderPolicy::getSymbol(library, "napi_register_module_v1");
-    if (NULL != initFn) {
-      log_debug("[%s] Found napi_register_module_v1 (%p)", libraryName.c_str(),
-                initFn);
-      addon.init = (napi_addon_register_func)initFn;
+jsi::Value CxxNodeApiHostModule::requireNodeAddonAsync(
+    jsi::Runtime &rt, react::TurboModule &turboModule, const jsi::Value args[],
+    size_t count) {
+  auto &thisModule = static_cast<CxxNodeApiHostModule &>(turboModule);
+  if (1 == count && args[0].isString()) {
+    return thisModule.requireNodeAddonAsync(rt, args[0].asString(rt));
+  }
+  throw jsi::JSError(rt, "Expected the library name of a Node-API addon");
+}
+
+jsi::Value
+CxxNodeApiHostModule::requireNodeAddonAsync(jsi::Runtime &rt,
+                                            const jsi::String libraryName) {
+  std::string libraryNameStr = libraryName.utf8(rt);
+  return react::createPromiseAsJSIValue(
+      rt, [this, libraryNameStr = std::move(libraryNameStr)](
+              jsi::Runtime &rt, std::shared_ptr<react::Promise> promise) {
+        // Addons loaded already only have to be initialized, if at all
+        if (nodeAddons_.count(libraryNameStr)) {
+          settleNodeAddonPromise(rt, libraryNameStr, *promise);
+          return;
+        }
+        auto &promises = (*pendingLoads_)[libraryNameStr];
+        promises.push_back(std::move(promise));
+        if (promises.size() > 1) {
+          return;
+        }
+
+        // Waits for the addon if it's being preloaded, like the first
+        // `requireNodeAddon` would, but on a thread of the host
+        getThreadPool().submit(
+            [this, libraryNameStr,
+             pendingLoads = std::weak_ptr<PendingLoads>(pendingLoads_),
+             invoker = std::weak_ptr<react::CallInvoker>(callInvoker_)]() {
+              AddonLibrary library;
+              {
+                TraceScope trace{"load", libraryNameStr};
+                library = takeAddonLibrary(libraryNameStr);
+              }
+              const auto jsInvoker = invoker.lock();
+              if (!jsInvoker) {
+                if (NULL != library.moduleHandle) {
+                  closeAddonLibrary(library.moduleHandle);
+                }
+                return;
+              }
+              jsInvoker->invokeAsync([this, libraryNameStr, pendingLoads,
+                                      library = std::move(library)](
+                                         jsi::Runtime &rt) {
+                // The module is destroyed on the JS thread, which is the
+                // only thread accessing the pending loads
+                if (pendingLoads.expired()) {
+                  if (NULL != library.moduleHandle) {
+                    closeAddonLibrary(library.moduleHandle);
+                  }
+                  return;
+                }
+                settleNodeAddonLoad(rt, libraryNameStr, library);
+              });
+            },
+            TaskPriority::UserBlocking);
+      });
+}
+
+void CxxNodeApiHostModule::settleNodeAddonLoad(jsi::Runtime &rt,
+                                               const std::string &libraryName,
+                                               const AddonLibrary &library) {
+  const auto pending = pendingLoads_->extract(libraryName);
+
+  auto [it, inserted] = nodeAddons_.try_emplace(libraryName);
+  if (inserted) {
+    if (!loadNodeAddon(it->second, libraryName, library)) {
+      // Allows requiring the addon again, as nothing was loaded
+      nodeAddons_.erase(it);
+      const auto message = getLoadErrorMessage(libraryName, library);
+      for (const auto &promise : pending.mapped()) {
+        promise->reject(message);
+      }
+      return;
+    }
+  } else if (NULL != library.moduleHandle) {
+    // Required synchronously in the meantime, loading the library once more
+    closeAddonLibrary(library.moduleHandle);
+  }
+
+  for (const auto &promise : pending.mapped()) {
+    settleNodeAddonPromise(rt, libraryName, *promise);
+  }
+}
+
+void CxxNodeApiHostModule::settleNodeAddonPromise(
+    jsi::Runtime &rt, const std::string &libraryName, react::Promise &promise) {
+  try {
+    promise.resolve(
+        requireNodeAddon(rt, jsi::String::createFromUtf8(rt, libraryName)));
+  } catch (const jsi::JSError &error) {
+    promise.reject(error.getMessage());
+  }
+}
+
+jsi::Value
+CxxNodeApiHostModule::getTraceEvents(jsi::Runtime &rt,
+                                     react::TurboModule &turboModule,
+                                     const jsi::Value args[], size_t count) {
+  return jsi::String::createFromUtf8(rt, getTraceEventsJson());
+}
+
+jsi::Value
+CxxNodeApiHostModule::getNodeApiProfile(jsi::Runtime &rt,
+                                        react::TurboModule &turboModule,
+                                        const jsi::Value args[], size_t count) {
+  auto &thisModule = static_cast<CxxNodeApiHostModule &>(turboModule);
+  std::vector<WeakNodeApiProfileEntry> entries;
+  const bool profiling = weak_node_api_get_profile(
+      [](const WeakNodeApiProfileEntry &entry, void *context) {
+        static_cast<std::vector<WeakNodeApiProfileEntry> *>(context)
+            ->push_back(entry);
+      },
+      &entries);
+  if (!profiling) {
+    return jsi::Value::null();
+  }
+  if (count > 0 && args[0].isBool() && args[0].getBool()) {
+    weak_node_api_reset_profile();
+  }
+
+  // Functions not taking an env, and envs of other modules, have no addon
+  std::unordered_map<const void *, const std::string *> addonsByEnv;
+  for (const auto &[libraryName, addon] : thisModule.nodeAddons_) {
+    for (napi_env env : addon.envs) {
+      addonsByEnv[env] = &addon.libraryName;
+    }
+  }
+
+  jsi::Array result(rt, entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    const auto &entry = entries[i];
+    jsi::Object object(rt);
+    const auto addon = addonsByEnv.find(entry.env);
+    if (addon != addonsByEnv.end()) {
+      object.setProperty(rt, "addon",
+                         jsi::String::createFromUtf8(rt, *addon->second));
     } else {
-      log_debug("[%s] Failed to find napi_register_module_v1. Expecting the "
-                "addon to call napi_module_register to register itself.",
-                libraryName.c_str());
+      object.setProperty(rt, "addon", jsi::Value::null());
+    }
+    object.setProperty(rt, "function",
+                       jsi::String::createFromUtf8(rt, entry.function));
+    object.setProperty(rt, "calls", static_cast<double>(entry.calls));
+    object.setProperty(rt, "sampledCalls",
+                       static_cast<double>(entry.sampled_calls));
+    object.setProperty(rt, "sampledNs", static_cast<double>(entry.sampled_ns));
+    jsi::Array histogram(rt, WEAK_NODE_API_PROFILE_BUCKETS);
+    for (size_t bucket = 0; bucket < WEAK_NODE_API_PROFILE_BUCKETS; bucket++) {
+      histogram.setValueAtIndex(rt, bucket,
+                                static_cast<double>(entry.histogram[bucket]));
+    }
+    object.setProperty(rt, "histogram", std::move(histogram));
+    result.setValueAtIndex(rt, i, std::move(object));
+  }
+  return std::move(result);
+}
+
+bool CxxNodeApiHostModule::loadNodeAddon(NodeAddon &addon,
+                                         const std::string &libraryName,
+                                         const AddonLibrary &library) const {
+  if (NULL == library.init) {
+    // Nothing calls into a library the addon can't be initialized from
+    if (NULL != library.moduleHandle) {
+      closeAddonLibrary(library.moduleHandle);
     }
-    // TODO: Read "node_api_module_get_api_version_v1" to support the addon
-    // declaring its Node-API version
-    // @see
-    // https://github.com/callstackincubator/react-native-node-api/issues/4
-  } else {
-    log_debug("[%s] Failed to load library", libraryName.c_str());
-  }
-  return NULL != initFn;
+    return false;
+  }
+
+  addon.libraryName = libraryName;
+  addon.moduleHandle = library.moduleHandle;
+  addon.init = library.init;
+  addon.apiVersion = library.apiVersion;
+  addon.filePath = library.filePath;
+
+  // Generate a name allowing us to hand the exports object over to JSI when
+  // initializing. Instead of using random numbers to avoid name clashes, we
+  // just use the pointer address of the loaded module
+  char generatedName[32];
+  snprintf(generatedName, sizeof(generatedName), "RN$NodeAddon_%p",
+           addon.moduleHandle);
+  addon.generatedName = generatedName;
+  return true;
 }
 
 bool CxxNodeApiHostModule::initializeNodeModule(jsi::Runtime &rt,
-                                                NodeAddon &addon) {
+                                                NodeAddon &addon,
+                                                jsi::Value &error) {
   // We should check if the module has already been initialized
   assert(NULL != addon.moduleHandle);
   assert(NULL != addon.init);
   napi_status status = napi_ok;
-  // TODO: Read the version from the addon
-  // @see
-  // https://github.com/callstackincubator/react-native-node-api/issues/4
-  napi_env env = reinterpret_cast<napi_env>(rt.createNodeApiEnv(8));
+  // Create the env with the Node-API version declared by the addon
+  napi_env env = nullptr;
+  {
+    TraceScope trace{"createNodeApiEnv", addon.libraryName};
+    env = reinterpret_cast<napi_env>(rt.createNodeApiEnv(addon.apiVersion));
+  }
+
+  // Register the call invoker before calling into the addon, which might
+  // already queue async work from its init function. The invoker is forgotten
+  // by the last host cleanup hook run when tearing down the env.
+  setCallInvoker(env, callInvoker_);
+  addon.envs.push_back(env);
+  addHostCleanupHook(
+      env, [](void *arg) { removeCallInvoker(static_cast<napi_env>(arg)); },
+      env);
+  addHostCleanupHook(
+      env, [](void *arg) { weak_node_api_forget_profile_env(arg); }, env);
+  // Run the cleanup hooks of the addon when the runtime destroys the env, as
+  // the runtime would if the host didn't implement them
+  tearDownWithRuntime(env, addon.libraryName);
+  setModuleFileName(env, "file://" + addon.filePath);
 
   // Create the "exports" object
   napi_value exports;
@@ -117,17 +331,51 @@ bool CxxNodeApiHostModule::initializeNodeModule(jsi::Runtime &rt,
 
   // Call the addon init function to populate the "exports" object
   // Allowing it to replace the value entirely by its return value
-  exports = addon.init(env, exports);
+  {
+    TraceScope trace{"init", addon.libraryName};
+    exports = addon.init(env, exports);
+  }
+
+  // The init function fails by throwing or returning no exports, in which case
+  // what it threw is handed over instead
+  bool failed = NULL == exports;
+  bool pending = false;
+  status = napi_is_exception_pending(env, &pending);
+  assert(status == napi_ok);
+  if (pending) {
+    failed = true;
+    status = napi_get_and_clear_last_exception(env, &exports);
+    assert(status == napi_ok);
+  }
+  if (NULL == exports) {
+    log_warning("[%s] Init function returned no exports",
+                addon.libraryName.c_str());
+    return false;
+  }
 
+  // Node-API values can't be converted to JSI values directly, so the value is
+  // handed over through a property of the global object, deleted right away
   napi_value global;
-  napi_get_global(env, &global);
+  status = napi_get_global(env, &global);
+  assert(status == napi_ok);
+
+  napi_value key;
+  status = napi_create_string_utf8(env, addon.generatedName.c_str(),
+                                   NAPI_AUTO_LENGTH, &key);
+  assert(status == napi_ok);
+
+  status = napi_set_property(env, global, key, exports);
   assert(status == napi_ok);
 
-  status =
-      napi_set_named_property(env, global, addon.generatedName.data(), exports);
+  jsi::Value value = rt.global().getProperty(rt, addon.generatedName.c_str());
+  status = napi_delete_property(env, global, key, nullptr);
   assert(status == napi_ok);
 
-  callstack::nodeapihost::setCallInvoker(env, callInvoker_);
+  if (failed) {
+    error = std::move(value);
+    return false;
+  }
+  addon.exports = std::move(value);
   return true;
 }
 
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <ReactCommon/TurboModule.h>
+#include <ReactCommon/TurboModuleUtils.h>
 #include <jsi/jsi.h>
+#include "Versions.hpp"
 #include <node_api.h>
+#include <optional>
+#include <vector>
 
 #include "AddonLoaders.hpp"
+#include "AddonPreloader.hpp"
 
 namespace callstack::nodeapihost {
 
@@ -13,6 +18,15 @@ public:
   static constexpr const char *kModuleName = "NodeApiHost";
 
   CxxNodeApiHostModule(std::shared_ptr<facebook::react::CallInvoker> jsInvoker);
+  ~CxxNodeApiHostModule();
+
+  // Tears the envs of the addons down, running their cleanup hooks and
+  // instance data finalizers. The module can't tell when its runtime is
+  // destroyed, so this is left to embedders which can: It must be called on
+  // the JS thread while the runtime is still alive, after which the addons
+  // must not be used. Otherwise, the envs are only forgotten when the module
+  // is destroyed.
+  void invalidate();
 
   static facebook::jsi::Value
   requireNodeAddon(facebook::jsi::Runtime &rt,
@@ -21,20 +35,70 @@ public:
   facebook::jsi::Value requireNodeAddon(facebook::jsi::Runtime &rt,
                                         const facebook::jsi::String path);
 
+  // Returns a promise of the exports, loading the library of the addon on a
+  // background thread and only initializing it on the JS thread
+  static facebook::jsi::Value
+  requireNodeAddonAsync(facebook::jsi::Runtime &rt,
+                        facebook::react::TurboModule &turboModule,
+                        const facebook::jsi::Value args[], size_t count);
+  facebook::jsi::Value requireNodeAddonAsync(facebook::jsi::Runtime &rt,
+                                             const facebook::jsi::String path);
+
+  // Returns the trace events recorded while loading and initializing addons
+  static facebook::jsi::Value
+  getTraceEvents(facebook::jsi::Runtime &rt,
+                 facebook::react::TurboModule &turboModule,
+                 const facebook::jsi::Value args[], size_t count);
+
+  // Returns the calls addons made through weak-node-api per function, or null
+  // unless it was built for profiling. Passing true starts counting over.
+  static facebook::jsi::Value
+  getNodeApiProfile(facebook::jsi::Runtime &rt,
+                    facebook::react::TurboModule &turboModule,
+                    const facebook::jsi::Value args[], size_t count);
+
 protected:
   struct NodeAddon {
+    std::string libraryName;
     void *moduleHandle;
     napi_addon_register_func init;
+    int32_t apiVersion;
+    std::string filePath;
+    // The key of the global property the exports returned by "init" are handed
+    // over through
     std::string generatedName;
+    // The envs created for the addon, which use the call invoker of this module
+    std::vector<napi_env> envs;
+    // The exports of the addon in the runtime of this module, which are
+    // released with it, like the JS representation of every TurboModule
+    std::optional<facebook::jsi::Value> exports;
   };
   std::unordered_map<std::string, NodeAddon> nodeAddons_;
   std::shared_ptr<facebook::react::CallInvoker> callInvoker_;
 
+  // The promises of addons being loaded off the JS thread, by library name.
+  // Loads finishing after the module is destroyed find it released.
+  using PendingLoads = std::unordered_map<
+      std::string, std::vector<std::shared_ptr<facebook::react::Promise>>>;
+  std::shared_ptr<PendingLoads> pendingLoads_;
+
   using LoaderPolicy = PosixLoader; // FIXME: HACK: This is temporary workaround
                                     // for my lazyness (work on iOS and Android)
 
-  bool loadNodeAddon(NodeAddon &addon, const std::string &path) const;
-  bool initializeNodeModule(facebook::jsi::Runtime &rt, NodeAddon &addon);
+  // Returns false and closes the library if the addon can't be initialized
+  // from it, leaving the reason in the error of the library
+  bool loadNodeAddon(NodeAddon &addon, const std::string &libraryName,
+                     const AddonLibrary &library) const;
+  void settleNodeAddonLoad(facebook::jsi::Runtime &rt,
+                           const std::string &libraryName,
+                           const AddonLibrary &library);
+  void settleNodeAddonPromise(facebook::jsi::Runtime &rt,
+                              const std::string &libraryName,
+                              facebook::react::Promise &promise);
+  // Returns false if the init function of the addon failed, leaving what it
+  // threw, if anything, in "error"
+  bool initializeNodeModule(facebook::jsi::Runtime &rt, NodeAddon &addon,
+                            facebook::jsi::Value &error);
 };
 
 } // namespace callstack::nodeapihost
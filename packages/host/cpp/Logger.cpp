@@ -1,6 +1,12 @@
 #include "Logger.hpp"
+#include <atomic>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include "BoundedMpscQueue.hpp"
 
 #if defined(__ANDROID__)
 #include <android/log.h>
@@ -12,7 +18,16 @@
 namespace {
 constexpr auto LineFormat = "[%s] [NodeApiHost] ";
 
-enum class LogLevel { Debug, Warning, Error };
+// Messages are truncated to fit a record, keeping the buffer at 64 KiB
+constexpr size_t MaxMessageLength = 250;
+constexpr size_t BufferedRecords = 256;
+
+enum class LogLevel : uint8_t { Debug, Warning, Error };
+
+struct LogRecord {
+  LogLevel level;
+  char message[MaxMessageLength + 1];
+};
 
 constexpr std::string_view levelToString(LogLevel level) {
   switch (level) {
@@ -42,44 +57,123 @@ constexpr int androidLogLevel(LogLevel level) {
 }
 #endif
 
-void log_message_internal(LogLevel level, const char* format, va_list args) {
+void write_message(LogLevel level, const char* message) {
 #if defined(__ANDROID__)
-  __android_log_vprint(androidLogLevel(level), LOG_TAG, format, args);
+  __android_log_write(androidLogLevel(level), LOG_TAG, message);
 #elif defined(__APPLE__)
   // iOS or macOS
   const auto level_str = levelToString(level);
   fprintf(stderr, LineFormat, level_str.data());
-  vfprintf(stderr, format, args);
-  fprintf(stderr, "\n");
+  fprintf(stderr, "%s\n", message);
 #else
   // Fallback for other platforms
   const auto level_str = levelToString(level);
   fprintf(stdout, LineFormat, level_str.data());
-  vfprintf(stdout, format, args);
-  fprintf(stdout, "\n");
+  fprintf(stdout, "%s\n", message);
 #endif
 }
+
+class AsyncLogger {
+ public:
+  static AsyncLogger& get() {
+    // Never destroyed, as threads might log while static objects are
+    // destroyed. Buffered messages are written when the process exits.
+    static AsyncLogger* logger = [] {
+      const auto logger = new AsyncLogger();
+      std::atexit([] { AsyncLogger::get().flush(); });
+      return logger;
+    }();
+    return *logger;
+  }
+
+  void log(LogLevel level, const char* format, va_list args) {
+    // Errors skip the buffer, as do messages finding it full: Instead of
+    // dropping messages, the caller then writes the buffered ones itself
+    const auto pushed = level != LogLevel::Error &&
+                        records_.tryPushWith([&](LogRecord& record) {
+                          record.level = level;
+                          vsnprintf(record.message,
+                              sizeof(record.message),
+                              format,
+                              args);
+                        });
+
+    if (pushed) {
+      // Only the first message since the thread woke up has to wake it
+      if (pending_.fetch_add(1, std::memory_order_release) == 0) {
+        pending_.notify_one();
+      }
+      return;
+    }
+
+    LogRecord record{.level = level, .message = {}};
+    vsnprintf(record.message, sizeof(record.message), format, args);
+    std::lock_guard lock{consumerMutex_};
+    drain();
+    write_message(record.level, record.message);
+  }
+
+  void flush() {
+    std::lock_guard lock{consumerMutex_};
+    drain();
+  }
+
+ private:
+  AsyncLogger() : records_(BufferedRecords) {
+    std::thread([this]() { run(); }).detach();
+  }
+
+  void run() {
+    while (true) {
+      pending_.wait(0, std::memory_order_acquire);
+      pending_.exchange(0, std::memory_order_acquire);
+      flush();
+    }
+  }
+
+  // Must be called with the consumer mutex held, as the queue supports a
+  // single consumer only
+  void drain() {
+    while (records_.tryConsume([](LogRecord& record) {
+      write_message(record.level, record.message);
+    })) {
+    }
+  }
+
+  callstack::nodeapihost::BoundedMpscQueue<LogRecord> records_;
+  std::atomic<uint32_t> pending_{0};
+  std::mutex consumerMutex_;
+};
 }  // anonymous namespace
 
 namespace callstack::nodeapihost {
 
+#if NODE_API_HOST_MIN_LOG_LEVEL <= NODE_API_HOST_LOG_LEVEL_DEBUG
 void log_debug(const char* format, ...) {
-  // TODO: Disable logging in release builds
   va_list args;
   va_start(args, format);
-  log_message_internal(LogLevel::Debug, format, args);
+  AsyncLogger::get().log(LogLevel::Debug, format, args);
   va_end(args);
 }
+#endif
+#if NODE_API_HOST_MIN_LOG_LEVEL <= NODE_API_HOST_LOG_LEVEL_WARNING
 void log_warning(const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_message_internal(LogLevel::Warning, format, args);
+  AsyncLogger::get().log(LogLevel::Warning, format, args);
   va_end(args);
 }
+#endif
+#if NODE_API_HOST_MIN_LOG_LEVEL <= NODE_API_HOST_LOG_LEVEL_ERROR
 void log_error(const char* format, ...) {
   va_list args;
   va_start(args, format);
-  log_message_internal(LogLevel::Error, format, args);
+  AsyncLogger::get().log(LogLevel::Error, format, args);
   va_end(args);
 }
+#endif
+
+void flush_logs() {
+  AsyncLogger::get().flush();
+}
 }  // namespace callstack::nodeapihost
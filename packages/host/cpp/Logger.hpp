@@ -2,8 +2,52 @@
 
 #include <string>
 
+#define NODE_API_HOST_LOG_LEVEL_DEBUG 0
+#define NODE_API_HOST_LOG_LEVEL_WARNING 1
+#define NODE_API_HOST_LOG_LEVEL_ERROR 2
+#define NODE_API_HOST_LOG_LEVEL_NONE 3
+
+// Messages below this level are compiled out. Defaults to logging everything
+// in debug builds and only warnings and errors in release builds (CocoaPods
+// defines DEBUG for debug builds, while CMake defines NDEBUG for release).
+#ifndef NODE_API_HOST_MIN_LOG_LEVEL
+#if defined(NDEBUG) || (defined(__APPLE__) && !defined(DEBUG))
+#define NODE_API_HOST_MIN_LOG_LEVEL NODE_API_HOST_LOG_LEVEL_WARNING
+#else
+#define NODE_API_HOST_MIN_LOG_LEVEL NODE_API_HOST_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define NODE_API_HOST_LOG_FORMAT(index) \
+  __attribute__((format(printf, index, index + 1)))
+
 namespace callstack::nodeapihost {
-void log_debug(const char* format, ...);
-void log_warning(const char* format, ...);
-void log_error(const char* format, ...);
+
+// Debug messages and warnings are formatted on the calling thread into a
+// lock-free ring buffer and written by a background thread. Errors drain the
+// buffer and are written before returning, as they might precede an abort.
+
+#if NODE_API_HOST_MIN_LOG_LEVEL <= NODE_API_HOST_LOG_LEVEL_DEBUG
+void log_debug(const char* format, ...) NODE_API_HOST_LOG_FORMAT(1);
+#else
+inline void log_debug(const char* format, ...) NODE_API_HOST_LOG_FORMAT(1);
+inline void log_debug(const char*, ...) {}
+#endif
+
+#if NODE_API_HOST_MIN_LOG_LEVEL <= NODE_API_HOST_LOG_LEVEL_WARNING
+void log_warning(const char* format, ...) NODE_API_HOST_LOG_FORMAT(1);
+#else
+inline void log_warning(const char* format, ...) NODE_API_HOST_LOG_FORMAT(1);
+inline void log_warning(const char*, ...) {}
+#endif
+
+#if NODE_API_HOST_MIN_LOG_LEVEL <= NODE_API_HOST_LOG_LEVEL_ERROR
+void log_error(const char* format, ...) NODE_API_HOST_LOG_FORMAT(1);
+#else
+inline void log_error(const char* format, ...) NODE_API_HOST_LOG_FORMAT(1);
+inline void log_error(const char*, ...) {}
+#endif
+
+// Writes the buffered messages before returning
+void flush_logs();
 }  // namespace callstack::nodeapihost
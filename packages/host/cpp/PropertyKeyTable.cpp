@@ -0,0 +1,82 @@
+#include "PropertyKeyTable.hpp"
+#include <memory>
+#include "ReadMostlyMap.hpp"
+#include "RuntimeNodeApiLifecycle.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+// Looked up without locking on every property key an addon creates, while
+// only updated when an env creates its first key or goes away
+ReadMostlyMap<napi_env, std::shared_ptr<PropertyKeyTable>> tables;
+
+void removePropertyKeyTable(void* arg) {
+  // The env is being torn down and releases the references on its own
+  tables.erase(static_cast<napi_env>(arg));
+}
+}  // namespace
+
+template <typename Char, typename CreateString>
+napi_status PropertyKeyTable::intern(Keys<Char>& keys,
+    const Char* str,
+    size_t length,
+    napi_value* result,
+    CreateString createString) {
+  if (!str && length != 0) {
+    return napi_invalid_arg;
+  }
+  if (length == NAPI_AUTO_LENGTH) {
+    length = std::char_traits<Char>::length(str);
+  }
+  if (length > MaxInternedLength) {
+    return createString(env_, str, length, result);
+  }
+
+  const std::basic_string_view<Char> key{str, length};
+  if (const auto it = keys.find(key); it != keys.end()) {
+    return napi_get_reference_value(env_, it->second, result);
+  }
+
+  if (const auto status = createString(env_, str, length, result);
+      status != napi_ok) {
+    return status;
+  }
+  if (size_ < MaxInternedKeys) {
+    // Runtimes implementing versions before 10 might not support references
+    // to strings, in which case the key is just not interned
+    napi_ref ref;
+    if (napi_create_reference(env_, *result, 1, &ref) == napi_ok) {
+      keys.emplace(key, ref);
+      size_++;
+    }
+  }
+  return napi_ok;
+}
+
+napi_status PropertyKeyTable::latin1(
+    const char* str, size_t length, napi_value* result) {
+  return intern(latin1Keys_, str, length, result, ::napi_create_string_latin1);
+}
+
+napi_status PropertyKeyTable::utf8(
+    const char* str, size_t length, napi_value* result) {
+  return intern(utf8Keys_, str, length, result, ::napi_create_string_utf8);
+}
+
+napi_status PropertyKeyTable::utf16(
+    const char16_t* str, size_t length, napi_value* result) {
+  return intern(utf16Keys_, str, length, result, ::napi_create_string_utf16);
+}
+
+PropertyKeyTable* getPropertyKeyTable(napi_env env) {
+  // The table is only used and removed on the JS thread of the env, which
+  // keeps it alive after the lookup
+  if (const auto table = tables.get(env)) {
+    return table.get();
+  }
+  const auto table = std::make_shared<PropertyKeyTable>(env);
+  tables.set(env, table);
+  addHostCleanupHook(env, removePropertyKeyTable, env);
+  return table.get();
+}
+
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "Versions.hpp"
+#include "node_api.h"
+
+namespace callstack::nodeapihost {
+
+/**
+ * Interns the property keys created for a single env: Addons create the same
+ * few property names over and over, each call otherwise allocating a new
+ * string in the JS heap. Keys are looked up by their characters and returned
+ * from a reference held by the table, which is released with the env.
+ *
+ * Long keys and keys created once the table is full aren't interned, as they
+ * are unlikely to be repeated.
+ *
+ * Must only be used on the JS thread of the env.
+ */
+class PropertyKeyTable {
+ public:
+  static constexpr size_t MaxInternedKeys = 1024;
+  static constexpr size_t MaxInternedLength = 64;
+
+  explicit PropertyKeyTable(napi_env env) : env_(env) {}
+
+  PropertyKeyTable(const PropertyKeyTable&) = delete;
+  PropertyKeyTable& operator=(const PropertyKeyTable&) = delete;
+
+  napi_status latin1(const char* str, size_t length, napi_value* result);
+  napi_status utf8(const char* str, size_t length, napi_value* result);
+  napi_status utf16(const char16_t* str, size_t length, napi_value* result);
+
+ private:
+  // Looked up by string views of the characters passed in, without copying
+  template <typename Char>
+  struct Hash {
+    using is_transparent = void;
+    size_t operator()(std::basic_string_view<Char> key) const {
+      return std::hash<std::basic_string_view<Char>>{}(key);
+    }
+  };
+  template <typename Char>
+  using Keys = std::unordered_map<std::basic_string<Char>,
+      napi_ref,
+      Hash<Char>,
+      std::equal_to<>>;
+
+  template <typename Char, typename CreateString>
+  napi_status intern(Keys<Char>& keys,
+      const Char* str,
+      size_t length,
+      napi_value* result,
+      CreateString createString);
+
+  napi_env env_;
+  size_t size_{0};
+  // Latin-1 and UTF-8 only agree on ASCII, so they are interned separately
+  Keys<char> latin1Keys_;
+  Keys<char> utf8Keys_;
+  Keys<char16_t> utf16Keys_;
+};
+
+// Returns the table of the env, creating it on first use
+PropertyKeyTable* getPropertyKeyTable(napi_env env);
+
+}  // namespace callstack::nodeapihost
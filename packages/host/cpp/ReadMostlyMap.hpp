@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace callstack::nodeapihost {
+
+/**
+ * A map for lookups from any thread which are far more frequent than updates:
+ * Readers look values up in an immutable snapshot of the map, announcing
+ * themselves on one of two counters instead of taking a lock. Writers copy
+ * the snapshot, publish the updated copy and free the previous snapshot once
+ * the readers that might still use it are done, flipping readers over to the
+ * other counter to not wait on readers arriving in the meantime (a minimal
+ * form of read-copy-update).
+ */
+template <typename Key, typename Value>
+class ReadMostlyMap {
+ public:
+  using Map = std::unordered_map<Key, Value>;
+
+  ReadMostlyMap() : current_(new Map()) {}
+  ~ReadMostlyMap() { delete current_.load(); }
+
+  ReadMostlyMap(const ReadMostlyMap&) = delete;
+  ReadMostlyMap& operator=(const ReadMostlyMap&) = delete;
+
+  // Lock-free. Returns a default constructed value if the key is missing.
+  Value get(const Key& key) const {
+    auto& readers = readers_[epoch_.load() & 1];
+    readers.fetch_add(1);
+    const Map* map = current_.load();
+    const auto it = map->find(key);
+    Value result = it != map->end() ? it->second : Value{};
+    readers.fetch_sub(1);
+    return result;
+  }
+
+  void set(const Key& key, Value value) {
+    update([&](Map& map) { map.insert_or_assign(key, std::move(value)); });
+  }
+
+  void erase(const Key& key) {
+    update([&](Map& map) { map.erase(key); });
+  }
+
+  // Calls `modify` with a copy of the map, which replaces the current one
+  template <typename Modify>
+  void update(Modify&& modify) {
+    std::lock_guard lock{writerMutex_};
+    auto next = std::make_unique<Map>(*current_.load());
+    modify(*next);
+    const auto previous = current_.exchange(next.release());
+    synchronize();
+    delete previous;
+  }
+
+ private:
+  // Waits for readers that might have loaded the previous snapshot, which
+  // counted themselves on either counter before loading it
+  void synchronize() {
+    for (int i = 0; i < 2; i++) {
+      const auto epoch = epoch_.fetch_add(1);
+      while (readers_[epoch & 1].load() != 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  std::atomic<const Map*> current_;
+  std::atomic<uint32_t> epoch_{0};
+  mutable std::atomic<uint32_t> readers_[2]{};
+  std::mutex writerMutex_;
+};
+
+}  // namespace callstack::nodeapihost
@@ -1,25 +1,36 @@
 #include "RuntimeNodeApi.hpp"
+#include <cstring>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include "BufferPool.hpp"
 #include "Logger.hpp"
-#include "Versions.hpp"
-
-auto ArrayType = napi_uint8_array;
+#include "RuntimeNodeApiLifecycle.hpp"
+#include "TypedArrays.hpp"
 
 namespace callstack::nodeapihost {
+namespace {
+// Entries are stable until erased, keeping the returned strings valid
+std::mutex moduleFileNamesMutex;
+std::unordered_map<napi_env, std::string> moduleFileNames;
+
+void removeModuleFileName(void* arg) {
+  std::lock_guard lock{moduleFileNamesMutex};
+  moduleFileNames.erase(static_cast<napi_env>(arg));
+}
+}  // namespace
 
 napi_status napi_create_buffer(
     napi_env env, size_t length, void** data, napi_value* result) {
-  napi_value buffer;
-  if (const auto status = napi_create_arraybuffer(env, length, data, &buffer);
-      status != napi_ok) {
-    return status;
+  if (!result) {
+    return napi_invalid_arg;
   }
 
-  // Warning: The returned data structure does not fully align with the
-  // characteristics of a Buffer.
-  // @see
-  // https://github.com/callstackincubator/react-native-node-api/issues/171
-  return napi_create_typedarray(env, ArrayType, length, buffer, 0, result);
+  const auto pool = getBufferPool(env);
+  if (!pool) {
+    return napi_generic_failure;
+  }
+  return pool->allocate(length, data, result);
 }
 
 napi_status napi_create_buffer_copy(napi_env env,
@@ -27,17 +38,26 @@ napi_status napi_create_buffer_copy(napi_env env,
     const void* data,
     void** result_data,
     napi_value* result) {
-  if (!length || !data || !result) {
+  if ((length && !data) || !result) {
     return napi_invalid_arg;
   }
 
+  const auto pool = getBufferPool(env);
+  if (!pool) {
+    return napi_generic_failure;
+  }
   void* buffer = nullptr;
-  if (const auto status = ::napi_create_buffer(env, length, &buffer, result);
+  if (const auto status = pool->allocate(length, &buffer, result);
       status != napi_ok) {
     return status;
   }
 
-  std::memcpy(buffer, data, length);
+  if (length) {
+    std::memcpy(buffer, data, length);
+  }
+  if (result_data) {
+    *result_data = buffer;
+  }
   return napi_ok;
 }
 
@@ -51,56 +71,63 @@ napi_status napi_is_buffer(napi_env env, napi_value value, bool* result) {
     return napi_ok;
   }
 
-  napi_valuetype type{};
-  if (const auto status = napi_typeof(env, value, &type); status != napi_ok) {
-    return status;
-  }
-
-  if (type != napi_object && type != napi_external) {
-    *result = false;
-    return napi_ok;
-  }
-
-  auto isArrayBuffer{false};
-  if (const auto status = napi_is_arraybuffer(env, value, &isArrayBuffer);
-      status != napi_ok) {
-    return status;
-  }
+  // Like in Node.js, any view of an ArrayBuffer is accepted as a buffer
   auto isTypedArray{false};
   if (const auto status = napi_is_typedarray(env, value, &isTypedArray);
       status != napi_ok) {
     return status;
   }
-
-  *result = isArrayBuffer || isTypedArray;
-  return napi_ok;
+  if (isTypedArray) {
+    *result = true;
+    return napi_ok;
+  }
+  return napi_is_dataview(env, value, result);
 }
 
 napi_status napi_get_buffer_info(
     napi_env env, napi_value value, void** data, size_t* length) {
-  if (!data || !length) {
+  if (!value) {
     return napi_invalid_arg;
   }
-  *data = nullptr;
-  *length = 0;
-  if (!value) {
+
+  auto isTypedArray{false};
+  if (const auto status = napi_is_typedarray(env, value, &isTypedArray);
+      status != napi_ok) {
+    return status;
+  }
+  if (isTypedArray) {
+    napi_typedarray_type type{};
+    size_t elementCount = 0;
+    if (const auto status = napi_get_typedarray_info(
+            env, value, &type, &elementCount, data, nullptr, nullptr);
+        status != napi_ok) {
+      return status;
+    }
+    if (length) {
+      *length = elementCount * elementSize(type);
+    }
     return napi_ok;
   }
 
-  auto isArrayBuffer{false};
-  if (const auto status = napi_is_arraybuffer(env, value, &isArrayBuffer);
-      status == napi_ok && isArrayBuffer) {
-    return napi_get_arraybuffer_info(env, value, data, length);
+  auto isDataView{false};
+  if (const auto status = napi_is_dataview(env, value, &isDataView);
+      status != napi_ok) {
+    return status;
   }
-
-  auto isTypedArray{false};
-  if (const auto status = napi_is_typedarray(env, value, &isTypedArray);
-      status == napi_ok && isTypedArray) {
-    return napi_get_typedarray_info(
-        env, value, &ArrayType, length, data, nullptr, nullptr);
+  if (isDataView) {
+    size_t byteLength = 0;
+    if (const auto status = napi_get_dataview_info(
+            env, value, &byteLength, data, nullptr, nullptr);
+        status != napi_ok) {
+      return status;
+    }
+    if (length) {
+      *length = byteLength;
+    }
+    return napi_ok;
   }
 
-  return napi_ok;
+  return napi_invalid_arg;
 }
 
 napi_status napi_create_external_buffer(napi_env env,
@@ -109,18 +136,23 @@ napi_status napi_create_external_buffer(napi_env env,
     node_api_basic_finalize basic_finalize_cb,
     void* finalize_hint,
     napi_value* result) {
+  if (!result) {
+    return napi_invalid_arg;
+  }
+
+  const auto pool = getBufferPool(env);
+  if (!pool) {
+    return napi_generic_failure;
+  }
+
+  // The buffer views the memory of the addon, which is never copied
   napi_value buffer;
   if (const auto status = napi_create_external_arraybuffer(
           env, data, length, basic_finalize_cb, finalize_hint, &buffer);
       status != napi_ok) {
     return status;
   }
-
-  // Warning: The returned data structure does not fully align with the
-  // characteristics of a Buffer.
-  // @see
-  // https://github.com/callstackincubator/react-native-node-api/issues/171
-  return napi_create_typedarray(env, ArrayType, length, buffer, 0, result);
+  return pool->wrap(buffer, length, result);
 }
 
 void napi_fatal_error(const char* location,
@@ -159,4 +191,28 @@ napi_status napi_get_version(node_api_basic_env env, uint32_t* result) {
   return napi_ok;
 }
 
+napi_status node_api_get_module_file_name(
+    node_api_basic_env env, const char** result) {
+  if (!result) {
+    return napi_invalid_arg;
+  }
+
+  std::lock_guard lock{moduleFileNamesMutex};
+  const auto it = moduleFileNames.find(const_cast<napi_env>(env));
+  if (it == moduleFileNames.end()) {
+    *result = nullptr;
+    return napi_generic_failure;
+  }
+  *result = it->second.c_str();
+  return napi_ok;
+}
+
+void setModuleFileName(napi_env env, std::string fileName) {
+  {
+    std::lock_guard lock{moduleFileNamesMutex};
+    moduleFileNames.insert_or_assign(env, std::move(fileName));
+  }
+  addHostCleanupHook(env, removeModuleFileName, env);
+}
+
 }  // namespace callstack::nodeapihost
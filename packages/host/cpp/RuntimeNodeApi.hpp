@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+#include "Versions.hpp"
 #include "node_api.h"
 
 namespace callstack::nodeapihost {
@@ -33,4 +35,10 @@ napi_status napi_get_node_version(
     node_api_basic_env env, const napi_node_version** result);
 
 napi_status napi_get_version(node_api_basic_env env, uint32_t* result);
+
+napi_status node_api_get_module_file_name(
+    node_api_basic_env env, const char** result);
+
+// Sets the URL returned by node_api_get_module_file_name for an env
+void setModuleFileName(napi_env env, std::string fileName);
 }  // namespace callstack::nodeapihost
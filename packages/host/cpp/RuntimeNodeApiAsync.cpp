@@ -1,100 +1,235 @@
 #include "RuntimeNodeApiAsync.hpp"
 #include <ReactCommon/CallInvoker.h>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "AsyncWorkRegistry.hpp"
 #include "Logger.hpp"
+#include "ReadMostlyMap.hpp"
+#include "RuntimeNodeApiLifecycle.hpp"
+#include "ThreadPool.hpp"
 
-struct AsyncJob {
-  using IdType = uint64_t;
-  enum State { Created, Queued, Completed, Cancelled, Deleted };
+using callstack::nodeapihost::AsyncJob;
+using callstack::nodeapihost::AsyncWorkRegistry;
+using callstack::nodeapihost::ReadMostlyMap;
 
-  IdType id{};
-  State state{};
-  napi_env env;
-  napi_value async_resource;
-  napi_value async_resource_name;
-  napi_async_execute_callback execute;
-  napi_async_complete_callback complete;
-  void* data{nullptr};
+// Looked up from worker threads queueing work, while updated on the JS thread
+static ReadMostlyMap<napi_env, std::weak_ptr<facebook::react::CallInvoker>>
+    callInvokers;
+static AsyncWorkRegistry asyncWorkRegistry;
 
-  static AsyncJob* fromWork(napi_async_work work) {
-    return reinterpret_cast<AsyncJob*>(work);
-  }
-  static napi_async_work toWork(AsyncJob* job) {
-    return reinterpret_cast<napi_async_work>(job);
+namespace callstack::nodeapihost {
+namespace {
+std::mutex defaultPrioritiesMutex;
+std::unordered_map<napi_env, TaskPriority> defaultPriorities;
+
+void removeDefaultPriority(void* arg) {
+  std::lock_guard lock{defaultPrioritiesMutex};
+  defaultPriorities.erase(static_cast<napi_env>(arg));
+}
+
+TaskPriority getDefaultPriority(napi_env env) {
+  std::lock_guard lock{defaultPrioritiesMutex};
+  const auto it = defaultPriorities.find(env);
+  return it != defaultPriorities.end() ? it->second : TaskPriority::Default;
+}
+
+bool toTaskPriority(node_api_host_priority priority, TaskPriority& result) {
+  switch (priority) {
+    case node_api_host_priority_user_blocking:
+      result = TaskPriority::UserBlocking;
+      return true;
+    case node_api_host_priority_default:
+      result = TaskPriority::Default;
+      return true;
+    case node_api_host_priority_background:
+      result = TaskPriority::Background;
+      return true;
   }
-};
+  return false;
+}
+
+constexpr auto DefaultCompletionBudget = std::chrono::milliseconds(4);
 
-class AsyncWorkRegistry {
+// Completions of an env waiting for the JS thread, which are called in a
+// single hop for as long as the budget allows, to not pay for scheduling a
+// task per job when many jobs finish at once
+class CompletionQueue : public std::enable_shared_from_this<CompletionQueue> {
  public:
-  using IdType = AsyncJob::IdType;
-
-  std::shared_ptr<AsyncJob> create(napi_env env,
-      napi_value async_resource,
-      napi_value async_resource_name,
-      napi_async_execute_callback execute,
-      napi_async_complete_callback complete,
-      void* data) {
-    const auto job = std::shared_ptr<AsyncJob>(new AsyncJob{
-        .id = next_id(),
-        .state = AsyncJob::State::Created,
-        .env = env,
-        .async_resource = async_resource,
-        .async_resource_name = async_resource_name,
-        .execute = execute,
-        .complete = complete,
-        .data = data,
-    });
-
-    jobs_[job->id] = job;
-    return job;
-  }
-
-  std::shared_ptr<AsyncJob> get(napi_async_work work) const {
-    const auto job = AsyncJob::fromWork(work);
-    if (!job) {
-      return {};
+  // Can be called from any thread. The queue only captures the handle, which
+  // is looked up again to catch work deleted in the meantime.
+  void push(napi_async_work work,
+      const std::weak_ptr<facebook::react::CallInvoker>& invoker) {
+    {
+      std::lock_guard lock{mutex_};
+      ready_.push_back(work);
+      invoker_ = invoker;
+      if (drainScheduled_) {
+        return;
+      }
+      drainScheduled_ = true;
     }
-    if (const auto it = jobs_.find(job->id); it != jobs_.end()) {
-      return it->second;
+    scheduleDrain();
+  }
+
+  // Only called from the JS thread, a budget of zero lifting the limit
+  void setBudget(std::chrono::nanoseconds budget) { budget_ = budget; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void scheduleDrain() {
+    std::shared_ptr<facebook::react::CallInvoker> invoker;
+    {
+      std::lock_guard lock{mutex_};
+      invoker = invoker_.lock();
+      if (!invoker) {
+        log_debug(
+            "Error: CallInvoker was released before async work completed");
+        ready_.clear();
+        drainScheduled_ = false;
+        return;
+      }
     }
-    return {};
+    invoker->invokeAsync([self = shared_from_this()]() { self->drain(); });
   }
 
-  bool release(IdType id) {
-    if (const auto it = jobs_.find(id); it != jobs_.end()) {
-      it->second->state = AsyncJob::State::Deleted;
-      jobs_.erase(it);
-      return true;
+  // Runs on the JS thread, calling "complete" of the ready jobs until out of
+  // budget, but at least once to always make progress. Jobs getting ready
+  // meanwhile are completed by the same drain.
+  void drain() {
+    const auto start = Clock::now();
+    size_t completed = 0;
+    while (true) {
+      const auto outOfBudget = completed > 0 && budget_.count() > 0 &&
+                               Clock::now() - start >= budget_;
+      napi_async_work work;
+      {
+        std::lock_guard lock{mutex_};
+        if (ready_.empty()) {
+          drainScheduled_ = false;
+          return;
+        }
+        if (outOfBudget) {
+          break;
+        }
+        work = ready_.front();
+        ready_.pop_front();
+      }
+      complete(work);
+      completed++;
     }
-    return false;
+    // Yields the JS thread to rendering and other tasks before continuing
+    scheduleDrain();
   }
 
- private:
-  IdType next_id() {
-    if (current_id_ == std::numeric_limits<IdType>::max()) [[unlikely]] {
-      current_id_ = 0;
+  void complete(napi_async_work work) {
+    const auto job = asyncWorkRegistry.get(work);
+    if (!job) {
+      log_warning("Async job has been deleted before completion");
+      return;
+    }
+    const auto env = job->env.load();
+
+    napi_handle_scope scope;
+    if (napi_open_handle_scope(env, &scope) != napi_ok) {
+      log_error("Failed to open a handle scope for async work completion");
+      return;
+    }
+
+    const auto status =
+        job->state == AsyncJob::State::Cancelled ? napi_cancelled : napi_ok;
+    // Updated before calling "complete" as it may queue the work again
+    job->state = AsyncJob::State::Completed;
+    job->complete(env, status, job->data);
+
+    // Cleared to not fail the completions called after this one
+    bool isExceptionPending = false;
+    napi_is_exception_pending(env, &isExceptionPending);
+    if (isExceptionPending) {
+      napi_value exception;
+      napi_get_and_clear_last_exception(env, &exception);
+      log_error("Uncaught exception from async work completion");
     }
-    return ++current_id_;
+
+    napi_close_handle_scope(env, scope);
   }
 
-  IdType current_id_{0};
-  std::unordered_map<IdType, std::shared_ptr<AsyncJob>> jobs_;
+  std::mutex mutex_;
+  // Guarded by the mutex
+  std::deque<napi_async_work> ready_;
+  std::weak_ptr<facebook::react::CallInvoker> invoker_;
+  bool drainScheduled_{false};
+  // Only accessed from the JS thread
+  std::chrono::nanoseconds budget_{DefaultCompletionBudget};
 };
 
-static std::unordered_map<napi_env, std::weak_ptr<facebook::react::CallInvoker>>
-    callInvokers;
-static AsyncWorkRegistry asyncWorkRegistry;
+// Looked up from worker threads completing work, while created on the JS
+// thread when an env first queues work
+ReadMostlyMap<napi_env, std::shared_ptr<CompletionQueue>> completionQueues;
 
-namespace callstack::nodeapihost {
+void removeCompletionQueue(void* arg) {
+  completionQueues.erase(static_cast<napi_env>(arg));
+}
+
+std::shared_ptr<CompletionQueue> getCompletionQueue(napi_env env) {
+  if (auto queue = completionQueues.get(env)) {
+    return queue;
+  }
+  std::shared_ptr<CompletionQueue> result;
+  bool inserted = false;
+  completionQueues.update([&](auto& map) {
+    auto& queue = map[env];
+    if (!queue) {
+      queue = std::make_shared<CompletionQueue>();
+      inserted = true;
+    }
+    result = queue;
+  });
+  if (inserted) {
+    addHostCleanupHook(env, removeCompletionQueue, env);
+  }
+  return result;
+}
+
+// Hands the job over to the JS thread to call "complete". Workers pass the
+// invoker copied when queueing, as deleting the job resets its own.
+void scheduleCompletion(napi_async_work work,
+    napi_env env,
+    const std::weak_ptr<facebook::react::CallInvoker>& invoker) {
+  const auto queue = completionQueues.get(env);
+  if (!queue) {
+    log_warning("Env was torn down before async work completed");
+    return;
+  }
+  queue->push(work, invoker);
+}
+}  // namespace
 
 void setCallInvoker(napi_env env,
     const std::shared_ptr<facebook::react::CallInvoker>& invoker) {
-  callInvokers[env] = invoker;
+  callInvokers.set(env, invoker);
 }
 
 std::weak_ptr<facebook::react::CallInvoker> getCallInvoker(napi_env env) {
-  return callInvokers.contains(env)
-             ? callInvokers[env]
-             : std::weak_ptr<facebook::react::CallInvoker>{};
+  return callInvokers.get(env);
+}
+
+void removeCallInvoker(napi_env env) {
+  callInvokers.erase(env);
+}
+
+void removeCallInvoker(napi_env env,
+    const std::shared_ptr<facebook::react::CallInvoker>& invoker) {
+  callInvokers.update([&](auto& map) {
+    // Compares owners, as the invoker might have been released already
+    const auto it = map.find(env);
+    if (it != map.end() && !it->second.owner_before(invoker) &&
+        !invoker.owner_before(it->second)) {
+      map.erase(it);
+    }
+  });
 }
 
 napi_status napi_create_async_work(napi_env env,
@@ -104,14 +239,15 @@ napi_status napi_create_async_work(napi_env env,
     napi_async_complete_callback complete,
     void* data,
     napi_async_work* result) {
-  const auto job = asyncWorkRegistry.create(
+  const auto work = asyncWorkRegistry.create(
       env, async_resource, async_resource_name, execute, complete, data);
-  if (!job) {
-    log_debug("Error: Failed to create async work job");
+  if (!work) {
+    log_error("Failed to create async work job");
     return napi_generic_failure;
   }
 
-  *result = AsyncJob::toWork(job.get());
+  asyncWorkRegistry.get(work)->priority = getDefaultPriority(env);
+  *result = work;
   return napi_ok;
 }
 
@@ -119,33 +255,43 @@ napi_status napi_queue_async_work(
     node_api_basic_env env, napi_async_work work) {
   const auto job = asyncWorkRegistry.get(work);
   if (!job) {
-    log_debug("Error: Received null job in napi_queue_async_work");
+    log_warning("Received null job in napi_queue_async_work");
     return napi_invalid_arg;
   }
 
-  const auto invoker = getCallInvoker(env).lock();
-  if (!invoker) {
-    log_debug("Error: No CallInvoker available for async work");
+  job->invoker = getCallInvoker(env);
+  if (job->invoker.expired()) {
+    log_error("No CallInvoker available for async work");
     return napi_invalid_arg;
   }
 
-  invoker->invokeAsync([env, weakJob = std::weak_ptr{job}]() {
-    const auto job = weakJob.lock();
-    if (!job) {
-      log_debug("Error: Async job has been deleted before execution");
-      return;
-    }
-    if (job->state == AsyncJob::State::Queued) {
-      job->execute(job->env, job->data);
-    }
+  getCompletionQueue(env);
+  job->state = AsyncJob::State::Queued;
 
-    job->complete(env,
-        job->state == AsyncJob::State::Cancelled ? napi_cancelled : napi_ok,
-        job->data);
-    job->state = AsyncJob::State::Completed;
-  });
+  // Run "execute" on a worker and only hop to the JS thread for "complete".
+  // The task pins the job, so it isn't replaced by another job if deleted
+  // while queued, and is unpinned by whoever drops the task.
+  asyncWorkRegistry.pin(work);
+  job->queuedPriority = job->priority;
+  job->taskId = getThreadPool().submit(
+      [work, job, env = job->env.load(), invoker = job->invoker]() {
+        auto expected = AsyncJob::State::Queued;
+        if (job->state.compare_exchange_strong(
+                expected, AsyncJob::State::Running)) {
+          job->execute(job->env, job->data);
+          job->state = AsyncJob::State::Executed;
+          job->state.notify_all();
+        }
+        // Checked after the CAS, which fails for deleted jobs
+        if (asyncWorkRegistry.get(work)) {
+          scheduleCompletion(work, env, invoker);
+        } else {
+          log_warning("Async job has been deleted before execution");
+        }
+        asyncWorkRegistry.unpin(work);
+      },
+      job->queuedPriority);
 
-  job->state = AsyncJob::State::Queued;
   return napi_ok;
 }
 
@@ -153,12 +299,12 @@ napi_status napi_delete_async_work(
     node_api_basic_env env, napi_async_work work) {
   const auto job = asyncWorkRegistry.get(work);
   if (!job) {
-    log_debug("Error: Received non-existent job in napi_delete_async_work");
+    log_warning("Received non-existent job in napi_delete_async_work");
     return napi_invalid_arg;
   }
 
-  if (!asyncWorkRegistry.release(job->id)) {
-    log_debug("Error: Failed to release async work job");
+  if (!asyncWorkRegistry.release(work)) {
+    log_error("Failed to release async work job");
     return napi_generic_failure;
   }
 
@@ -169,22 +315,158 @@ napi_status napi_cancel_async_work(
     node_api_basic_env env, napi_async_work work) {
   const auto job = asyncWorkRegistry.get(work);
   if (!job) {
-    log_debug("Error: Received null job in napi_cancel_async_work");
+    log_warning("Received null job in napi_cancel_async_work");
     return napi_invalid_arg;
   }
   switch (job->state) {
+    case AsyncJob::State::Running:
+    case AsyncJob::State::Executed:
+      log_warning("Cannot cancel async work that has already started");
+      return napi_generic_failure;
     case AsyncJob::State::Completed:
-      log_debug("Error: Cannot cancel async work that is already completed");
+      log_warning("Cannot cancel async work that is already completed");
       return napi_generic_failure;
     case AsyncJob::State::Deleted:
-      log_debug("Warning: Async work job is already deleted");
+      log_warning("Async work job is already deleted");
       return napi_generic_failure;
     case AsyncJob::State::Cancelled:
-      log_debug("Warning: Async work job is already cancelled");
+      log_warning("Async work job is already cancelled");
       return napi_ok;
+    case AsyncJob::State::Created:
+    case AsyncJob::State::Queued:
+      break;
   }
 
-  job->state = AsyncJob::State::Cancelled;
+  // The job might have been picked up by a worker since the check above
+  auto expected = AsyncJob::State::Queued;
+  if (!job->state.compare_exchange_strong(
+          expected, AsyncJob::State::Cancelled)) {
+    log_warning("Cannot cancel async work that is not queued");
+    return napi_generic_failure;
+  }
+  // Unless a worker just picked the job up, it's dropped from the queue
+  // without waiting for its turn, to complete right away
+  if (getThreadPool().cancel(job->taskId, job->queuedPriority)) {
+    asyncWorkRegistry.unpin(work);
+    scheduleCompletion(work, job->env, job->invoker);
+  }
   return napi_ok;
 }
+
+napi_status node_api_host_set_async_work_priority(
+    napi_env env, napi_async_work work, node_api_host_priority priority) {
+  const auto job = asyncWorkRegistry.get(work);
+  TaskPriority taskPriority;
+  if (!job || !toTaskPriority(priority, taskPriority)) {
+    return napi_invalid_arg;
+  }
+  job->priority = taskPriority;
+  return napi_ok;
+}
+
+napi_status node_api_host_set_default_async_work_priority(
+    napi_env env, node_api_host_priority priority) {
+  TaskPriority taskPriority;
+  if (!env || !toTaskPriority(priority, taskPriority)) {
+    return napi_invalid_arg;
+  }
+  std::lock_guard lock{defaultPrioritiesMutex};
+  const auto [it, inserted] =
+      defaultPriorities.insert_or_assign(env, taskPriority);
+  if (inserted) {
+    addHostCleanupHook(env, removeDefaultPriority, env);
+  }
+  return napi_ok;
+}
+
+napi_status node_api_host_get_async_work_stats(
+    napi_env env, node_api_host_async_work_stats* result) {
+  if (!result) {
+    return napi_invalid_arg;
+  }
+  const auto stats = getThreadPool().stats();
+  result->queued_user_blocking =
+      stats.queued[static_cast<size_t>(TaskPriority::UserBlocking)];
+  result->queued_default =
+      stats.queued[static_cast<size_t>(TaskPriority::Default)];
+  result->queued_background =
+      stats.queued[static_cast<size_t>(TaskPriority::Background)];
+  result->started = stats.started;
+  result->cancelled = stats.cancelled;
+  result->total_wait_ns = stats.totalWait.count();
+  result->max_wait_ns = stats.maxWait.count();
+  return napi_ok;
+}
+
+napi_status node_api_host_set_async_completion_budget(
+    napi_env env, uint64_t budget_ns) {
+  if (!env) {
+    return napi_invalid_arg;
+  }
+  getCompletionQueue(env)->setBudget(std::chrono::nanoseconds(budget_ns));
+  return napi_ok;
+}
+
+napi_status node_api_host_submit(
+    node_api_host_priority priority, node_api_host_task task, void* data) {
+  TaskPriority taskPriority;
+  if (!task || !toTaskPriority(priority, taskPriority)) {
+    return napi_invalid_arg;
+  }
+  getThreadPool().submit([task, data]() { task(data); }, taskPriority);
+  return napi_ok;
+}
+
+napi_status node_api_host_parallel_for(
+    size_t count, node_api_host_loop_body body, void* data) {
+  if (!body) {
+    return napi_invalid_arg;
+  }
+  getThreadPool().parallelFor(
+      count, [body, data](size_t index) { body(data, index); });
+  return napi_ok;
+}
+
+napi_status node_api_host_get_thread_count(size_t* result) {
+  if (!result) {
+    return napi_invalid_arg;
+  }
+  *result = getThreadPool().size();
+  return napi_ok;
+}
+
+void cancelAsyncWork(napi_env env) {
+  asyncWorkRegistry.forEach([env](napi_async_work work, AsyncJob& job) {
+    auto expected = AsyncJob::State::Queued;
+    if (job.env == env &&
+        job.state.compare_exchange_strong(
+            expected, AsyncJob::State::Cancelled)) {
+      if (getThreadPool().cancel(job.taskId, job.queuedPriority)) {
+        asyncWorkRegistry.unpin(work);
+      }
+    }
+  });
+  // Like Node.js, waits for "execute" to return instead of interrupting it.
+  // Only waits once all queued work is cancelled, to not start any more.
+  asyncWorkRegistry.forEach([env](napi_async_work work, AsyncJob& job) {
+    if (job.env != env) {
+      return;
+    }
+    for (auto state = job.state.load(); state == AsyncJob::State::Running;
+         state = job.state.load()) {
+      job.state.wait(state);
+    }
+  });
+}
+
+size_t releaseAsyncWork(napi_env env) {
+  size_t released = 0;
+  asyncWorkRegistry.forEach([env, &released](napi_async_work work,
+                                AsyncJob& job) {
+    if (job.env == env && asyncWorkRegistry.release(work)) {
+      released++;
+    }
+  });
+  return released;
+}
 }  // namespace callstack::nodeapihost
@@ -2,12 +2,24 @@
 
 #include <ReactCommon/CallInvoker.h>
 #include <memory>
+#include "Versions.hpp"
 #include "node_api.h"
+#include "node_api_host.h"
 
 namespace callstack::nodeapihost {
 void setCallInvoker(
     napi_env env, const std::shared_ptr<facebook::react::CallInvoker>& invoker);
 
+std::weak_ptr<facebook::react::CallInvoker> getCallInvoker(napi_env env);
+
+// Forgets the invoker of an env being torn down
+void removeCallInvoker(napi_env env);
+
+// Forgets the invoker of an env, unless the env has been assigned another one,
+// as envs might be allocated at the address of a destroyed env
+void removeCallInvoker(napi_env env,
+    const std::shared_ptr<facebook::react::CallInvoker>& invoker);
+
 napi_status napi_create_async_work(napi_env env,
     napi_value async_resource,
     napi_value async_resource_name,
@@ -23,4 +35,33 @@ napi_status napi_delete_async_work(
 
 napi_status napi_cancel_async_work(
     node_api_basic_env env, napi_async_work work);
+
+napi_status node_api_host_set_async_work_priority(
+    napi_env env, napi_async_work work, node_api_host_priority priority);
+
+napi_status node_api_host_set_default_async_work_priority(
+    napi_env env, node_api_host_priority priority);
+
+napi_status node_api_host_get_async_work_stats(
+    napi_env env, node_api_host_async_work_stats* result);
+
+napi_status node_api_host_set_async_completion_budget(
+    napi_env env, uint64_t budget_ns);
+
+napi_status node_api_host_submit(
+    node_api_host_priority priority, node_api_host_task task, void* data);
+
+napi_status node_api_host_parallel_for(
+    size_t count, node_api_host_loop_body body, void* data);
+
+napi_status node_api_host_get_thread_count(size_t* result);
+
+// Cancels the queued async work of an env being torn down and waits for the
+// work being executed, before its cleanup hooks release the data of the work
+void cancelAsyncWork(napi_env env);
+
+// Releases the async work of a torn down env which the addon didn't delete,
+// dropping completions still on their way to the JS thread. Returns the number
+// of released jobs.
+size_t releaseAsyncWork(napi_env env);
 }  // namespace callstack::nodeapihost
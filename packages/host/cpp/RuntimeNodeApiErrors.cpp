@@ -0,0 +1,83 @@
+#include "RuntimeNodeApiErrors.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+napi_status expectString(napi_env env, napi_value value) {
+  napi_valuetype type;
+  if (const auto status = napi_typeof(env, value, &type); status != napi_ok) {
+    return status;
+  }
+  return type == napi_string ? napi_ok : napi_string_expected;
+}
+}  // namespace
+
+// Like napi_create_error, the code is set as the "code" property, if given
+napi_status node_api_create_syntax_error(
+    napi_env env, napi_value code, napi_value msg, napi_value* result) {
+  if (!env || !msg || !result) {
+    return napi_invalid_arg;
+  }
+  if (const auto status = expectString(env, msg); status != napi_ok) {
+    return status;
+  }
+  if (code) {
+    if (const auto status = expectString(env, code); status != napi_ok) {
+      return status;
+    }
+  }
+
+  napi_value global;
+  if (const auto status = napi_get_global(env, &global); status != napi_ok) {
+    return status;
+  }
+  napi_value constructor;
+  if (const auto status =
+          napi_get_named_property(env, global, "SyntaxError", &constructor);
+      status != napi_ok) {
+    return status;
+  }
+  napi_value error;
+  if (const auto status = napi_new_instance(env, constructor, 1, &msg, &error);
+      status != napi_ok) {
+    return status;
+  }
+  if (code) {
+    if (const auto status = napi_set_named_property(env, error, "code", code);
+        status != napi_ok) {
+      return status;
+    }
+  }
+  *result = error;
+  return napi_ok;
+}
+
+napi_status node_api_throw_syntax_error(
+    napi_env env, const char* code, const char* msg) {
+  if (!env || !msg) {
+    return napi_invalid_arg;
+  }
+  napi_value codeValue = nullptr;
+  if (code) {
+    if (const auto status =
+            napi_create_string_utf8(env, code, NAPI_AUTO_LENGTH, &codeValue);
+        status != napi_ok) {
+      return status;
+    }
+  }
+  napi_value msgValue;
+  if (const auto status =
+          napi_create_string_utf8(env, msg, NAPI_AUTO_LENGTH, &msgValue);
+      status != napi_ok) {
+    return status;
+  }
+  // Qualified, as the runtime declares the same function
+  napi_value error;
+  if (const auto status = nodeapihost::node_api_create_syntax_error(
+          env, codeValue, msgValue, &error);
+      status != napi_ok) {
+    return status;
+  }
+  return napi_throw(env, error);
+}
+
+}  // namespace callstack::nodeapihost
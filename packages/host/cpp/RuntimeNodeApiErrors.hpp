@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Versions.hpp"
+#include "node_api.h"
+
+// Error functions of Node-API 9, implemented by the host on top of the
+// functions of earlier versions, which the runtime implements
+
+namespace callstack::nodeapihost {
+napi_status node_api_create_syntax_error(
+    napi_env env, napi_value code, napi_value msg, napi_value* result);
+
+napi_status node_api_throw_syntax_error(
+    napi_env env, const char* code, const char* msg);
+}  // namespace callstack::nodeapihost
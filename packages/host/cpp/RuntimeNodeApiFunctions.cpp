@@ -0,0 +1,270 @@
+#include "RuntimeNodeApiFunctions.hpp"
+#include <array>
+#include <string>
+#include <utility>
+#include "TypedArrays.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+constexpr size_t MaxArgs = NODE_API_HOST_TYPED_FUNCTION_MAX_ARGS;
+
+using ReadValue = napi_status (*)(
+    napi_env env, napi_value value, node_api_host_value& result);
+using CreateValue = napi_status (*)(
+    napi_env env, const node_api_host_value& value, napi_value* result);
+
+// Converts between JS values and the member of node_api_host_value of a type,
+// specialized per type so a function is called through a converter chosen
+// once when it's created
+template <node_api_host_type Type>
+struct TypedValue;
+
+template <>
+struct TypedValue<node_api_host_type_void> {
+  static constexpr const char* expected = nullptr;
+  static constexpr ReadValue read = nullptr;
+  static napi_status create(
+      napi_env env, const node_api_host_value& value, napi_value* result) {
+    *result = nullptr;
+    return napi_ok;
+  }
+};
+
+template <>
+struct TypedValue<node_api_host_type_bool> {
+  static constexpr const char* expected = "a boolean";
+  static napi_status read(
+      napi_env env, napi_value value, node_api_host_value& result) {
+    return napi_get_value_bool(env, value, &result.boolean);
+  }
+  static napi_status create(
+      napi_env env, const node_api_host_value& value, napi_value* result) {
+    return napi_get_boolean(env, value.boolean, result);
+  }
+};
+
+template <>
+struct TypedValue<node_api_host_type_int32> {
+  static constexpr const char* expected = "a number";
+  static napi_status read(
+      napi_env env, napi_value value, node_api_host_value& result) {
+    return napi_get_value_int32(env, value, &result.int32);
+  }
+  static napi_status create(
+      napi_env env, const node_api_host_value& value, napi_value* result) {
+    return napi_create_int32(env, value.int32, result);
+  }
+};
+
+template <>
+struct TypedValue<node_api_host_type_uint32> {
+  static constexpr const char* expected = "a number";
+  static napi_status read(
+      napi_env env, napi_value value, node_api_host_value& result) {
+    return napi_get_value_uint32(env, value, &result.uint32);
+  }
+  static napi_status create(
+      napi_env env, const node_api_host_value& value, napi_value* result) {
+    return napi_create_uint32(env, value.uint32, result);
+  }
+};
+
+template <>
+struct TypedValue<node_api_host_type_int64> {
+  static constexpr const char* expected = "a number";
+  static napi_status read(
+      napi_env env, napi_value value, node_api_host_value& result) {
+    return napi_get_value_int64(env, value, &result.int64);
+  }
+  static napi_status create(
+      napi_env env, const node_api_host_value& value, napi_value* result) {
+    return napi_create_int64(env, value.int64, result);
+  }
+};
+
+template <>
+struct TypedValue<node_api_host_type_double> {
+  static constexpr const char* expected = "a number";
+  static napi_status read(
+      napi_env env, napi_value value, node_api_host_value& result) {
+    return napi_get_value_double(env, value, &result.number);
+  }
+  static napi_status create(
+      napi_env env, const node_api_host_value& value, napi_value* result) {
+    return napi_create_double(env, value.number, result);
+  }
+};
+
+template <>
+struct TypedValue<node_api_host_type_buffer> {
+  static constexpr const char* expected =
+      "a typed array, DataView or ArrayBuffer";
+  // Typed arrays are checked first, as the most common views
+  static napi_status read(
+      napi_env env, napi_value value, node_api_host_value& result) {
+    auto& buffer = result.buffer;
+    bool is = false;
+    if (napi_is_typedarray(env, value, &is) == napi_ok && is) {
+      napi_typedarray_type type;
+      size_t length;
+      if (const auto status = napi_get_typedarray_info(
+              env, value, &type, &length, &buffer.data, nullptr, nullptr);
+          status != napi_ok) {
+        return status;
+      }
+      buffer.byte_length = length * elementSize(type);
+      return napi_ok;
+    }
+    if (napi_is_dataview(env, value, &is) == napi_ok && is) {
+      return napi_get_dataview_info(
+          env, value, &buffer.byte_length, &buffer.data, nullptr, nullptr);
+    }
+    if (napi_is_arraybuffer(env, value, &is) == napi_ok && is) {
+      return napi_get_arraybuffer_info(
+          env, value, &buffer.data, &buffer.byte_length);
+    }
+    return napi_invalid_arg;
+  }
+  static constexpr CreateValue create = nullptr;
+};
+
+struct Converters {
+  ReadValue read;
+  CreateValue create;
+  const char* expected;
+};
+
+template <node_api_host_type Type>
+constexpr Converters convertersOf() {
+  return {TypedValue<Type>::read,
+      TypedValue<Type>::create,
+      TypedValue<Type>::expected};
+}
+
+Converters getConverters(node_api_host_type type) {
+  switch (type) {
+    case node_api_host_type_void:
+      return convertersOf<node_api_host_type_void>();
+    case node_api_host_type_bool:
+      return convertersOf<node_api_host_type_bool>();
+    case node_api_host_type_int32:
+      return convertersOf<node_api_host_type_int32>();
+    case node_api_host_type_uint32:
+      return convertersOf<node_api_host_type_uint32>();
+    case node_api_host_type_int64:
+      return convertersOf<node_api_host_type_int64>();
+    case node_api_host_type_double:
+      return convertersOf<node_api_host_type_double>();
+    case node_api_host_type_buffer:
+      return convertersOf<node_api_host_type_buffer>();
+    default:
+      return {};
+  }
+}
+
+struct TypedFunction {
+  node_api_host_typed_callback cb;
+  void* data;
+  std::array<Converters, MaxArgs> args;
+  CreateValue createResult;
+};
+
+void throwArgumentError(napi_env env, size_t index, const char* expected) {
+  const auto message = "Expected argument " + std::to_string(index + 1) +
+                       " to be " + expected;
+  napi_throw_type_error(env, nullptr, message.c_str());
+}
+
+// The callback of functions with `ArgCount` arguments, getting the arguments
+// and the function in a single call
+template <size_t ArgCount>
+napi_value callTypedFunction(napi_env env, napi_callback_info info) {
+  size_t argc = ArgCount;
+  std::array<napi_value, ArgCount> argv{};
+  void* data = nullptr;
+  if (napi_get_cb_info(env, info, &argc, argv.data(), nullptr, &data) !=
+      napi_ok) {
+    return nullptr;
+  }
+  const auto& function = *static_cast<const TypedFunction*>(data);
+
+  std::array<node_api_host_value, ArgCount> args{};
+  for (size_t i = 0; i < ArgCount; i++) {
+    const auto& arg = function.args[i];
+    if (i >= argc || arg.read(env, argv[i], args[i]) != napi_ok) {
+      throwArgumentError(env, i, arg.expected);
+      return nullptr;
+    }
+  }
+
+  node_api_host_value result{};
+  function.cb(function.data, args.data(), &result);
+  napi_value value = nullptr;
+  if (function.createResult(env, result, &value) != napi_ok) {
+    return nullptr;
+  }
+  return value;
+}
+
+template <size_t... ArgCounts>
+constexpr std::array<napi_callback, sizeof...(ArgCounts)> makeCallbacks(
+    std::index_sequence<ArgCounts...>) {
+  return {callTypedFunction<ArgCounts>...};
+}
+
+// The callback per number of arguments
+constexpr auto callbacks =
+    makeCallbacks(std::make_index_sequence<MaxArgs + 1>{});
+
+void deleteTypedFunction(napi_env env, void* data, void* hint) {
+  delete static_cast<TypedFunction*>(data);
+}
+}  // namespace
+
+napi_status node_api_host_create_typed_function(napi_env env,
+    const char* utf8name,
+    size_t length,
+    const node_api_host_type* arg_types,
+    size_t arg_count,
+    node_api_host_type result_type,
+    node_api_host_typed_callback cb,
+    void* data,
+    napi_value* result) {
+  if (!env || !cb || !result || arg_count > MaxArgs ||
+      (arg_count > 0 && !arg_types)) {
+    return napi_invalid_arg;
+  }
+
+  auto function = new TypedFunction{cb, data, {}, nullptr};
+  for (size_t i = 0; i < arg_count; i++) {
+    function->args[i] = getConverters(arg_types[i]);
+    if (!function->args[i].read) {
+      delete function;
+      return napi_invalid_arg;
+    }
+  }
+  function->createResult = getConverters(result_type).create;
+  if (!function->createResult) {
+    delete function;
+    return napi_invalid_arg;
+  }
+
+  napi_value value;
+  if (const auto status = napi_create_function(
+          env, utf8name, length, callbacks[arg_count], function, &value);
+      status != napi_ok) {
+    delete function;
+    return status;
+  }
+  if (const auto status = napi_add_finalizer(
+          env, value, function, deleteTypedFunction, nullptr, nullptr);
+      status != napi_ok) {
+    delete function;
+    return status;
+  }
+
+  *result = value;
+  return napi_ok;
+}
+
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Versions.hpp"
+#include "node_api.h"
+#include "node_api_host.h"
+
+namespace callstack::nodeapihost {
+napi_status node_api_host_create_typed_function(napi_env env,
+    const char* utf8name,
+    size_t length,
+    const node_api_host_type* arg_types,
+    size_t arg_count,
+    node_api_host_type result_type,
+    node_api_host_typed_callback cb,
+    void* data,
+    napi_value* result);
+}  // namespace callstack::nodeapihost
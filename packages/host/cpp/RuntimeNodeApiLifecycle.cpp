@@ -0,0 +1,276 @@
+#include "RuntimeNodeApiLifecycle.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "Logger.hpp"
+#include "ReadMostlyMap.hpp"
+#include "RuntimeNodeApiAsync.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+struct AsyncCleanupHook {
+  napi_env env;
+  napi_async_cleanup_hook hook;
+  void* arg;
+
+  static AsyncCleanupHook* fromHandle(napi_async_cleanup_hook_handle handle) {
+    return reinterpret_cast<AsyncCleanupHook*>(handle);
+  }
+  napi_async_cleanup_hook_handle toHandle() {
+    return reinterpret_cast<napi_async_cleanup_hook_handle>(this);
+  }
+};
+
+// Either kind of hook, as both are run in the reverse order they were added
+struct CleanupHook {
+  napi_cleanup_hook fun{nullptr};
+  void* arg{nullptr};
+  AsyncCleanupHook* async{nullptr};
+
+  bool operator==(const CleanupHook& other) const = default;
+};
+
+struct EnvState {
+  std::mutex mutex;
+  // Guarded by the mutex, which isn't held while running the hooks
+  std::vector<CleanupHook> hooks;
+  std::vector<CleanupHook> hostHooks;
+  // The async hooks which haven't been removed yet, including those which ran
+  std::unordered_set<AsyncCleanupHook*> asyncHooks;
+
+  // Only accessed from the JS thread
+  // The addon of the env, set if the runtime tears the env down
+  std::string name;
+  bool tornDownByRuntime{false};
+  void* instanceData{nullptr};
+  napi_finalize instanceDataFinalize{nullptr};
+  void* instanceDataHint{nullptr};
+};
+
+// Looked up without locking, as addons built with node-addon-api get the
+// instance data on every call of an instance method
+ReadMostlyMap<napi_env, std::shared_ptr<EnvState>> envStates;
+
+std::shared_ptr<EnvState> getEnvState(napi_env env) {
+  if (auto state = envStates.get(env)) {
+    return state;
+  }
+  std::shared_ptr<EnvState> result;
+  envStates.update([&](auto& map) {
+    auto& state = map[env];
+    if (!state) {
+      state = std::make_shared<EnvState>();
+    }
+    result = state;
+  });
+  return result;
+}
+
+// Hooks might add or remove other hooks while running, so they are taken off
+// the list one at a time
+void runCleanupHooks(EnvState& state, std::vector<CleanupHook>& hooks) {
+  while (true) {
+    CleanupHook hook;
+    {
+      std::lock_guard lock{state.mutex};
+      if (hooks.empty()) {
+        return;
+      }
+      hook = hooks.back();
+      hooks.pop_back();
+    }
+    if (hook.async) {
+      // Removed by the addon once done, possibly later on
+      hook.async->hook(hook.async->toHandle(), hook.async->arg);
+    } else {
+      hook.fun(hook.arg);
+    }
+  }
+}
+}  // namespace
+
+napi_status napi_add_env_cleanup_hook(
+    node_api_basic_env env, napi_cleanup_hook fun, void* arg) {
+  if (!env || !fun) {
+    return napi_invalid_arg;
+  }
+  const auto state = getEnvState(env);
+  const CleanupHook hook{.fun = fun, .arg = arg};
+  std::lock_guard lock{state->mutex};
+  if (std::find(state->hooks.begin(), state->hooks.end(), hook) !=
+      state->hooks.end()) {
+    log_warning("Cleanup hook has already been added");
+    return napi_invalid_arg;
+  }
+  state->hooks.push_back(hook);
+  return napi_ok;
+}
+
+napi_status napi_remove_env_cleanup_hook(
+    node_api_basic_env env, napi_cleanup_hook fun, void* arg) {
+  if (!env || !fun) {
+    return napi_invalid_arg;
+  }
+  const auto state = envStates.get(env);
+  if (!state) {
+    return napi_ok;
+  }
+  const CleanupHook hook{.fun = fun, .arg = arg};
+  std::lock_guard lock{state->mutex};
+  std::erase(state->hooks, hook);
+  return napi_ok;
+}
+
+napi_status napi_add_async_cleanup_hook(node_api_basic_env env,
+    napi_async_cleanup_hook hook,
+    void* arg,
+    napi_async_cleanup_hook_handle* remove_handle) {
+  if (!env || !hook) {
+    return napi_invalid_arg;
+  }
+  const auto state = getEnvState(env);
+  auto* async = new AsyncCleanupHook{.env = env, .hook = hook, .arg = arg};
+  {
+    std::lock_guard lock{state->mutex};
+    state->hooks.push_back(CleanupHook{.async = async});
+    state->asyncHooks.insert(async);
+  }
+  if (remove_handle) {
+    *remove_handle = async->toHandle();
+  }
+  return napi_ok;
+}
+
+napi_status napi_remove_async_cleanup_hook(
+    napi_async_cleanup_hook_handle remove_handle) {
+  if (!remove_handle) {
+    return napi_invalid_arg;
+  }
+  auto* async = AsyncCleanupHook::fromHandle(remove_handle);
+  // The env is gone if the hook was removed after it had been torn down
+  if (const auto state = envStates.get(async->env)) {
+    std::lock_guard lock{state->mutex};
+    std::erase(state->hooks, CleanupHook{.async = async});
+    state->asyncHooks.erase(async);
+  }
+  delete async;
+  return napi_ok;
+}
+
+// Like Node.js, replacing the instance data doesn't finalize the previous data
+napi_status napi_set_instance_data(node_api_basic_env env,
+    void* data,
+    napi_finalize finalize_cb,
+    void* finalize_hint) {
+  if (!env) {
+    return napi_invalid_arg;
+  }
+  const auto state = getEnvState(env);
+  state->instanceData = data;
+  state->instanceDataFinalize = finalize_cb;
+  state->instanceDataHint = finalize_hint;
+  return napi_ok;
+}
+
+napi_status napi_get_instance_data(node_api_basic_env env, void** data) {
+  if (!env || !data) {
+    return napi_invalid_arg;
+  }
+  const auto state = envStates.get(env);
+  *data = state ? state->instanceData : nullptr;
+  return napi_ok;
+}
+
+void addHostCleanupHook(napi_env env, napi_cleanup_hook fun, void* arg) {
+  const auto state = getEnvState(env);
+  std::lock_guard lock{state->mutex};
+  state->hostHooks.push_back(CleanupHook{.fun = fun, .arg = arg});
+}
+
+void removeHostCleanupHook(napi_env env, napi_cleanup_hook fun, void* arg) {
+  if (const auto state = envStates.get(env)) {
+    std::lock_guard lock{state->mutex};
+    std::erase(state->hostHooks, CleanupHook{.fun = fun, .arg = arg});
+  }
+}
+
+namespace {
+void tearDownEnvState(napi_env env, const std::string& name) {
+  // The cleanup hooks might release data used by the work
+  cancelAsyncWork(env);
+
+  size_t leakedAsyncHooks = 0;
+  if (const auto state = envStates.get(env)) {
+    runCleanupHooks(*state, state->hooks);
+
+    if (const auto finalize = state->instanceDataFinalize) {
+      state->instanceDataFinalize = nullptr;
+      finalize(env, state->instanceData, state->instanceDataHint);
+    }
+    state->instanceData = nullptr;
+
+    runCleanupHooks(*state, state->hostHooks);
+
+    std::lock_guard lock{state->mutex};
+    leakedAsyncHooks = state->asyncHooks.size();
+  }
+  envStates.erase(env);
+
+  const auto leakedAsyncWork = releaseAsyncWork(env);
+  if (leakedAsyncWork > 0 || leakedAsyncHooks > 0) {
+    log_warning(
+        "[%s] Leaked %zu async work and %zu async cleanup hooks, which were "
+        "not deleted or removed when the env was torn down",
+        name.c_str(),
+        leakedAsyncWork,
+        leakedAsyncHooks);
+  }
+}
+
+// Added to the runtime's own cleanup hooks, which it runs when destroying the
+// env while the env can still be called into
+void tearDownFromRuntime(void* arg) {
+  const auto env = static_cast<napi_env>(arg);
+  if (const auto state = envStates.get(env)) {
+    tearDownEnvState(env, state->name);
+  }
+}
+}  // namespace
+
+void tearDownEnv(napi_env env, const std::string& name) {
+  if (const auto state = envStates.get(env); state && state->tornDownByRuntime) {
+    ::napi_remove_env_cleanup_hook(env, tearDownFromRuntime, env);
+  }
+  tearDownEnvState(env, name);
+}
+
+void tearDownWithRuntime(napi_env env, const std::string& name) {
+  const auto state = getEnvState(env);
+  if (const auto status =
+          ::napi_add_env_cleanup_hook(env, tearDownFromRuntime, env);
+      status != napi_ok) {
+    log_error("[%s] Failed to add a cleanup hook tearing the env down",
+        name.c_str());
+    return;
+  }
+  state->name = name;
+  state->tornDownByRuntime = true;
+}
+
+void forgetEnv(napi_env env) {
+  // Left to the runtime, which might destroy the env after the module
+  if (const auto state = envStates.get(env); state && state->tornDownByRuntime) {
+    return;
+  }
+  cancelAsyncWork(env);
+  if (const auto state = envStates.get(env)) {
+    runCleanupHooks(*state, state->hostHooks);
+  }
+  envStates.erase(env);
+  releaseAsyncWork(env);
+}
+
+}  // namespace callstack::nodeapihost
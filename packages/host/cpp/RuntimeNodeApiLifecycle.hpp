@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include "Versions.hpp"
+#include "node_api.h"
+
+// Cleanup hooks and instance data, which the host keeps per env to run them
+// when tearing the env down, instead of leaving it to the runtime. The host's
+// own per-env state is released by host cleanup hooks.
+
+namespace callstack::nodeapihost {
+napi_status napi_add_env_cleanup_hook(
+    node_api_basic_env env, napi_cleanup_hook fun, void* arg);
+
+napi_status napi_remove_env_cleanup_hook(
+    node_api_basic_env env, napi_cleanup_hook fun, void* arg);
+
+napi_status napi_add_async_cleanup_hook(node_api_basic_env env,
+    napi_async_cleanup_hook hook,
+    void* arg,
+    napi_async_cleanup_hook_handle* remove_handle);
+
+napi_status napi_remove_async_cleanup_hook(
+    napi_async_cleanup_hook_handle remove_handle);
+
+napi_status napi_set_instance_data(node_api_basic_env env,
+    void* data,
+    napi_finalize finalize_cb,
+    void* finalize_hint);
+
+napi_status napi_get_instance_data(node_api_basic_env env, void** data);
+
+// Adds a hook releasing state the host keeps for an env, which must not call
+// Node-API: Host hooks run after the hooks and the instance data finalizer of
+// the addon when the env is torn down, and on their own when it's forgotten.
+void addHostCleanupHook(napi_env env, napi_cleanup_hook fun, void* arg);
+
+void removeHostCleanupHook(napi_env env, napi_cleanup_hook fun, void* arg);
+
+// Tears an env down like Node.js does when an env exits:
+// 1. Cancels queued async work and waits for the work being executed.
+// 2. Runs the cleanup hooks, the latest added first.
+// 3. Calls the finalizer of the instance data.
+// 4. Runs the host cleanup hooks and releases async work the addon didn't
+//    delete.
+// Resources the addon didn't release are logged as leaks of the addon `name`.
+// Must be called on the JS thread while the runtime is still alive, as the
+// hooks and the finalizer call into it. They are called without a handle
+// scope, like other finalizers. The env must not be used afterwards.
+void tearDownEnv(napi_env env, const std::string& name);
+
+// Tears an env down once its runtime destroys it, through a cleanup hook of
+// the runtime, such as when React Native reloads or closes the app. Envs torn
+// down before aren't torn down again.
+void tearDownWithRuntime(napi_env env, const std::string& name);
+
+// Forgets an env whose runtime is being destroyed or is gone already, without
+// calling into the addon or the runtime: Cancels queued async work and waits
+// for the work being executed, then runs the host cleanup hooks and releases
+// the async work. The cleanup hooks and the instance data finalizer of the
+// addon are skipped, as they would call Node-API on a dying env. Envs which
+// the runtime tears down are left to it.
+void forgetEnv(napi_env env);
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,154 @@
+#include "RuntimeNodeApiObjects.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "PropertyKeyTable.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+// Handles of the created objects and values are released in batches
+constexpr size_t RecordsPerHandleScope = 256;
+
+size_t fieldSize(node_api_host_field_type type) {
+  switch (type) {
+    case node_api_host_field_bool:
+      return sizeof(bool);
+    case node_api_host_field_int32:
+    case node_api_host_field_uint32:
+      return sizeof(int32_t);
+    case node_api_host_field_int64:
+    case node_api_host_field_bigint64:
+      return sizeof(int64_t);
+    case node_api_host_field_double:
+      return sizeof(double);
+    case node_api_host_field_string:
+      return sizeof(const char*);
+    default:
+      return 0;
+  }
+}
+
+// Records are packed by the addon, so fields might not be aligned
+template <typename T>
+T readField(const uint8_t* record, size_t offset) {
+  T value;
+  std::memcpy(&value, record + offset, sizeof(T));
+  return value;
+}
+
+napi_status createValue(napi_env env,
+    const node_api_host_field& field,
+    const uint8_t* record,
+    napi_value* result) {
+  switch (field.type) {
+    case node_api_host_field_bool:
+      return napi_get_boolean(
+          env, readField<bool>(record, field.offset), result);
+    case node_api_host_field_int32:
+      return napi_create_int32(
+          env, readField<int32_t>(record, field.offset), result);
+    case node_api_host_field_uint32:
+      return napi_create_uint32(
+          env, readField<uint32_t>(record, field.offset), result);
+    case node_api_host_field_int64:
+      return napi_create_int64(
+          env, readField<int64_t>(record, field.offset), result);
+    case node_api_host_field_double:
+      return napi_create_double(
+          env, readField<double>(record, field.offset), result);
+    case node_api_host_field_bigint64:
+      return napi_create_bigint_int64(
+          env, readField<int64_t>(record, field.offset), result);
+    case node_api_host_field_string:
+      if (const auto str = readField<const char*>(record, field.offset)) {
+        return ::napi_create_string_utf8(env, str, NAPI_AUTO_LENGTH, result);
+      }
+      return napi_get_null(env, result);
+    default:
+      return napi_invalid_arg;
+  }
+}
+
+napi_status createKey(napi_env env, const char* name, napi_value* result) {
+  if (auto* table = getPropertyKeyTable(env)) {
+    return table->utf8(name, NAPI_AUTO_LENGTH, result);
+  }
+  return ::napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, result);
+}
+}  // namespace
+
+napi_status node_api_host_create_object_array(napi_env env,
+    const node_api_host_field* fields,
+    size_t field_count,
+    const void* records,
+    size_t record_size,
+    size_t record_count,
+    napi_value* result) {
+  if (!result || (field_count > 0 && !fields) ||
+      (record_count > 0 && !records) || record_count > UINT32_MAX) {
+    return napi_invalid_arg;
+  }
+
+  // The keys are created once, with a descriptor per field reused for every
+  // record, defining all properties of an object in a single call
+  std::vector<napi_property_descriptor> descriptors(field_count);
+  for (size_t i = 0; i < field_count; i++) {
+    const auto& field = fields[i];
+    const auto size = fieldSize(field.type);
+    if (!field.name || size == 0 || field.offset + size > record_size) {
+      return napi_invalid_arg;
+    }
+    if (const auto status = createKey(env, field.name, &descriptors[i].name);
+        status != napi_ok) {
+      return status;
+    }
+    descriptors[i].attributes = napi_default_jsproperty;
+  }
+
+  napi_value array;
+  if (const auto status =
+          napi_create_array_with_length(env, record_count, &array);
+      status != napi_ok) {
+    return status;
+  }
+
+  const auto* data = static_cast<const uint8_t*>(records);
+  for (size_t start = 0; start < record_count;
+       start += RecordsPerHandleScope) {
+    napi_handle_scope scope;
+    if (const auto status = napi_open_handle_scope(env, &scope);
+        status != napi_ok) {
+      return status;
+    }
+    const auto end = std::min(start + RecordsPerHandleScope, record_count);
+    for (size_t index = start; index < end; index++) {
+      const auto* record = data + index * record_size;
+      napi_value object;
+      auto status = napi_create_object(env, &object);
+      for (size_t i = 0; i < field_count && status == napi_ok; i++) {
+        status = createValue(env, fields[i], record, &descriptors[i].value);
+      }
+      if (status == napi_ok) {
+        status = napi_define_properties(
+            env, object, field_count, descriptors.data());
+      }
+      if (status == napi_ok) {
+        status = napi_set_element(env, array, index, object);
+      }
+      if (status != napi_ok) {
+        napi_close_handle_scope(env, scope);
+        return status;
+      }
+    }
+    if (const auto status = napi_close_handle_scope(env, scope);
+        status != napi_ok) {
+      return status;
+    }
+  }
+
+  *result = array;
+  return napi_ok;
+}
+
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Versions.hpp"
+#include "node_api.h"
+#include "node_api_host.h"
+
+namespace callstack::nodeapihost {
+napi_status node_api_host_create_object_array(napi_env env,
+    const node_api_host_field* fields,
+    size_t field_count,
+    const void* records,
+    size_t record_size,
+    size_t record_count,
+    napi_value* result);
+}  // namespace callstack::nodeapihost
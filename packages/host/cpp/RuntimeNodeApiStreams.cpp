@@ -0,0 +1,396 @@
+#include "RuntimeNodeApiStreams.hpp"
+#include <ReactCommon/CallInvoker.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Logger.hpp"
+#include "RuntimeNodeApiAsync.hpp"
+#include "RuntimeNodeApiLifecycle.hpp"
+#include "TypedArrays.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+class Stream;
+
+// The streams of an env with elements to pass to JS, which are all passed in
+// a single hop to the JS thread
+class StreamGroup : public std::enable_shared_from_this<StreamGroup> {
+ public:
+  explicit StreamGroup(std::weak_ptr<facebook::react::CallInvoker> invoker)
+      : invoker_(std::move(invoker)) {}
+
+  void schedule(std::shared_ptr<Stream> stream);
+
+  // Track the streams not finalized yet, on the JS thread
+  void add(Stream* stream) { streams_.push_back(stream); }
+  void remove(Stream* stream) { std::erase(streams_, stream); }
+
+  // Closes every stream not finalized yet, when the env goes away
+  void closeStreams(bool deleteReferences);
+
+ private:
+  void drain();
+
+  const std::weak_ptr<facebook::react::CallInvoker> invoker_;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<Stream>> ready_;
+  bool drainScheduled_{false};
+  // Only accessed from the JS thread
+  std::vector<Stream*> streams_;
+};
+
+class Stream : public std::enable_shared_from_this<Stream> {
+ public:
+  Stream(napi_env env,
+      size_t elementSize,
+      size_t capacity,
+      std::shared_ptr<StreamGroup> group)
+      : env_(env),
+        elementSize_(elementSize),
+        capacity_(capacity),
+        // Allocated as doubles, aligning the elements of every type
+        data_(std::make_unique<double[]>(
+            (capacity * elementSize + sizeof(double) - 1) / sizeof(double))),
+        group_(std::move(group)) {}
+
+  static Stream* fromHandle(node_api_host_stream stream) {
+    return reinterpret_cast<Stream*>(stream);
+  }
+  node_api_host_stream toHandle() {
+    return reinterpret_cast<node_api_host_stream>(this);
+  }
+
+  void* data() { return data_.get(); }
+  size_t byteLength() const { return capacity_ * elementSize_; }
+
+  // Keeps the stream alive until it's released and finalized
+  void retainSelf(napi_ref view, napi_ref callback) {
+    view_ = view;
+    callback_ = callback;
+    self_ = shared_from_this();
+    group_->add(this);
+  }
+
+  napi_status write(const void* data, size_t count, size_t* written) {
+    if (released_.load() || closed_.load()) {
+      return napi_closing;
+    }
+    // Only the producer moves the write position, only JS the read position
+    const auto writePosition = writePosition_.load(std::memory_order_relaxed);
+    const auto readPosition = readPosition_.load(std::memory_order_acquire);
+    count = std::min(count, capacity_ - (writePosition - readPosition));
+
+    // Copies up to the end of the ring buffer, continuing from its start
+    const auto start = writePosition % capacity_;
+    const auto first = std::min(count, capacity_ - start);
+    auto* bytes = reinterpret_cast<uint8_t*>(data_.get());
+    std::memcpy(bytes + start * elementSize_, data, first * elementSize_);
+    std::memcpy(bytes,
+        static_cast<const uint8_t*>(data) + first * elementSize_,
+        (count - first) * elementSize_);
+
+    // Sequentially consistent with `scheduled_`, so a dispatch which already
+    // cleared it sees the elements, while a pending one is scheduled again
+    writePosition_.store(writePosition + count);
+    if (written) {
+      *written = count;
+    }
+    if (count > 0) {
+      schedule();
+    }
+    return napi_ok;
+  }
+
+  napi_status release() {
+    // Taken first, as closing the stream drops it once released
+    const auto self = shared_from_this();
+    if (released_.exchange(true)) {
+      return napi_invalid_arg;
+    }
+    if (closed_.load()) {
+      releaseSelf();
+      return napi_ok;
+    }
+    // Passes the remaining elements, then finalizes on the JS thread
+    schedule();
+    return napi_ok;
+  }
+
+  // Runs on the JS thread when the env goes away, deleting the references
+  // unless the runtime is being destroyed. Writes fail from now on, and the
+  // stream is deleted once released, if it isn't already.
+  void close(bool deleteReferences) {
+    closed_.store(true);
+    finalize(deleteReferences);
+    if (released_.load()) {
+      releaseSelf();
+    }
+  }
+
+  // Runs on the JS thread
+  void dispatch() {
+    scheduled_.store(false);
+    if (finalized_) {
+      return;
+    }
+    // Read before the elements, to finalize only once they're all passed
+    const auto released = released_.load();
+    const auto readPosition = readPosition_.load(std::memory_order_relaxed);
+    const auto writePosition = writePosition_.load();
+    if (writePosition != readPosition) {
+      call(readPosition % capacity_, writePosition - readPosition);
+      readPosition_.store(writePosition, std::memory_order_release);
+    }
+    if (released) {
+      finalize(true);
+      // Might delete this instance, while the view keeps the elements alive
+      releaseSelf();
+    }
+  }
+
+ private:
+  void schedule() {
+    // Coalesces writes into a single call, until the call is dispatched
+    if (!scheduled_.exchange(true)) {
+      group_->schedule(shared_from_this());
+    }
+  }
+
+  void call(size_t offset, size_t count) {
+    napi_handle_scope scope;
+    if (napi_open_handle_scope(env_, &scope) != napi_ok) {
+      log_error("Failed to open a handle scope for a stream");
+      return;
+    }
+
+    napi_value view, callback, undefined;
+    napi_value args[3];
+    if (napi_get_reference_value(env_, view_, &view) == napi_ok &&
+        napi_get_reference_value(env_, callback_, &callback) == napi_ok &&
+        napi_get_undefined(env_, &undefined) == napi_ok &&
+        napi_create_double(env_, static_cast<double>(offset), &args[1]) ==
+            napi_ok &&
+        napi_create_double(env_, static_cast<double>(count), &args[2]) ==
+            napi_ok) {
+      args[0] = view;
+      napi_call_function(env_, undefined, callback, 3, args, nullptr);
+    }
+
+    bool isExceptionPending = false;
+    napi_is_exception_pending(env_, &isExceptionPending);
+    if (isExceptionPending) {
+      napi_value exception;
+      napi_get_and_clear_last_exception(env_, &exception);
+      log_error("Uncaught exception from stream callback");
+    }
+
+    napi_close_handle_scope(env_, scope);
+  }
+
+  void finalize(bool deleteReferences) {
+    finalized_ = true;
+    if (deleteReferences) {
+      napi_delete_reference(env_, view_);
+      napi_delete_reference(env_, callback_);
+    }
+    view_ = nullptr;
+    callback_ = nullptr;
+    group_->remove(this);
+  }
+
+  // Both releasing and closing the stream might be last, on different threads
+  void releaseSelf() {
+    if (!selfReleased_.exchange(true)) {
+      self_.reset();
+    }
+  }
+
+  const napi_env env_;
+  const size_t elementSize_;
+  const size_t capacity_;
+  const std::unique_ptr<double[]> data_;
+  const std::shared_ptr<StreamGroup> group_;
+  std::shared_ptr<Stream> self_;
+
+  // Counts of elements written and read, kept apart to avoid false sharing
+  alignas(64) std::atomic<size_t> writePosition_{0};
+  alignas(64) std::atomic<size_t> readPosition_{0};
+  std::atomic<bool> scheduled_{false};
+  std::atomic<bool> released_{false};
+  std::atomic<bool> closed_{false};
+  std::atomic<bool> selfReleased_{false};
+  // Only accessed from the JS thread
+  napi_ref view_{nullptr};
+  napi_ref callback_{nullptr};
+  bool finalized_{false};
+};
+
+void StreamGroup::schedule(std::shared_ptr<Stream> stream) {
+  {
+    std::lock_guard lock{mutex_};
+    ready_.push_back(std::move(stream));
+    if (drainScheduled_) {
+      return;
+    }
+    drainScheduled_ = true;
+  }
+  const auto invoker = invoker_.lock();
+  if (!invoker) {
+    log_error("No CallInvoker available for stream");
+    std::lock_guard lock{mutex_};
+    ready_.clear();
+    drainScheduled_ = false;
+    return;
+  }
+  invoker->invokeAsync([self = shared_from_this()]() { self->drain(); });
+}
+
+void StreamGroup::closeStreams(bool deleteReferences) {
+  // Closing a stream removes it from the list
+  const auto streams = streams_;
+  for (auto* stream : streams) {
+    stream->close(deleteReferences);
+  }
+}
+
+void StreamGroup::drain() {
+  std::vector<std::shared_ptr<Stream>> ready;
+  {
+    std::lock_guard lock{mutex_};
+    ready.swap(ready_);
+    drainScheduled_ = false;
+  }
+  for (const auto& stream : ready) {
+    stream->dispatch();
+  }
+}
+
+std::mutex groupsMutex;
+std::unordered_map<napi_env, std::shared_ptr<StreamGroup>> groups;
+
+std::shared_ptr<StreamGroup> findStreamGroup(napi_env env) {
+  std::lock_guard lock{groupsMutex};
+  const auto it = groups.find(env);
+  return it != groups.end() ? it->second : nullptr;
+}
+
+// Runs with the cleanup hooks of the addon when the env is torn down, while
+// the references of the streams can still be deleted
+void closeStreams(void* arg) {
+  if (const auto group = findStreamGroup(static_cast<napi_env>(arg))) {
+    group->closeStreams(true);
+  }
+}
+
+// Also runs when the env is forgotten, closing streams left open
+void removeStreamGroup(void* arg) {
+  std::shared_ptr<StreamGroup> group;
+  {
+    std::lock_guard lock{groupsMutex};
+    const auto it = groups.find(static_cast<napi_env>(arg));
+    if (it == groups.end()) {
+      return;
+    }
+    group = std::move(it->second);
+    groups.erase(it);
+  }
+  group->closeStreams(false);
+}
+
+std::shared_ptr<StreamGroup> getStreamGroup(napi_env env) {
+  std::lock_guard lock{groupsMutex};
+  auto& group = groups[env];
+  if (!group) {
+    const auto invoker = getCallInvoker(env);
+    if (invoker.expired()) {
+      log_error("No CallInvoker available for stream");
+      groups.erase(env);
+      return nullptr;
+    }
+    ::napi_add_env_cleanup_hook(env, closeStreams, env);
+    addHostCleanupHook(env, removeStreamGroup, env);
+    group = std::make_shared<StreamGroup>(invoker);
+  }
+  return group;
+}
+
+void deleteStreamData(napi_env env, void* data, void* hint) {
+  delete static_cast<std::shared_ptr<Stream>*>(hint);
+}
+}  // namespace
+
+napi_status node_api_host_create_stream(napi_env env,
+    napi_typedarray_type type,
+    size_t capacity,
+    napi_value callback,
+    node_api_host_stream* result) {
+  const auto size = elementSize(type);
+  if (!env || !callback || !result || capacity == 0 || size == 0) {
+    return napi_invalid_arg;
+  }
+  auto group = getStreamGroup(env);
+  if (!group) {
+    return napi_generic_failure;
+  }
+
+  auto stream = std::make_shared<Stream>(env, size, capacity, std::move(group));
+
+  // The view shares ownership of the elements, which JS might hold on to
+  // after the stream is deleted
+  napi_value arraybuffer;
+  auto* owner = new std::shared_ptr<Stream>(stream);
+  if (const auto status = napi_create_external_arraybuffer(env,
+          stream->data(),
+          stream->byteLength(),
+          deleteStreamData,
+          owner,
+          &arraybuffer);
+      status != napi_ok) {
+    delete owner;
+    return status;
+  }
+
+  napi_value view;
+  napi_ref viewRef, callbackRef;
+  if (const auto status =
+          napi_create_typedarray(env, type, capacity, arraybuffer, 0, &view);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status = napi_create_reference(env, view, 1, &viewRef);
+      status != napi_ok) {
+    return status;
+  }
+  if (const auto status = napi_create_reference(env, callback, 1, &callbackRef);
+      status != napi_ok) {
+    napi_delete_reference(env, viewRef);
+    return status;
+  }
+
+  stream->retainSelf(viewRef, callbackRef);
+  *result = stream->toHandle();
+  return napi_ok;
+}
+
+napi_status node_api_host_stream_write(node_api_host_stream stream,
+    const void* data,
+    size_t count,
+    size_t* written) {
+  if (!stream || (!data && count > 0)) {
+    return napi_invalid_arg;
+  }
+  return Stream::fromHandle(stream)->write(data, count, written);
+}
+
+napi_status node_api_host_release_stream(node_api_host_stream stream) {
+  if (!stream) {
+    return napi_invalid_arg;
+  }
+  return Stream::fromHandle(stream)->release();
+}
+
+}  // namespace callstack::nodeapihost
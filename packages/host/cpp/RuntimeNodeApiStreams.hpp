@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Versions.hpp"
+#include "node_api.h"
+#include "node_api_host.h"
+
+namespace callstack::nodeapihost {
+napi_status node_api_host_create_stream(napi_env env,
+    napi_typedarray_type type,
+    size_t capacity,
+    napi_value callback,
+    node_api_host_stream* result);
+
+napi_status node_api_host_stream_write(node_api_host_stream stream,
+    const void* data,
+    size_t count,
+    size_t* written);
+
+napi_status node_api_host_release_stream(node_api_host_stream stream);
+}  // namespace callstack::nodeapihost
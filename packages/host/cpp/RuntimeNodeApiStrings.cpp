@@ -0,0 +1,123 @@
+#include "RuntimeNodeApiStrings.hpp"
+#include "PropertyKeyTable.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+// Hermes has no strings backed by external memory, so the string is always
+// copied. Like Node.js does when copying, the finalizer is called right away,
+// as the caller expects the memory to be released once it's no longer used.
+template <typename Char, typename CreateString>
+napi_status createCopiedString(napi_env env,
+    Char* str,
+    size_t length,
+    node_api_basic_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result,
+    bool* copied,
+    CreateString createString) {
+  if (const auto status = createString(env, str, length, result);
+      status != napi_ok) {
+    return status;
+  }
+  if (copied) {
+    *copied = true;
+  }
+  if (finalize_callback) {
+    finalize_callback(env, str, finalize_hint);
+  }
+  return napi_ok;
+}
+}  // namespace
+
+// Looks the symbol up in the global registry through Symbol.for
+napi_status node_api_symbol_for(napi_env env,
+    const char* utf8description,
+    size_t length,
+    napi_value* result) {
+  if (!env || !result) {
+    return napi_invalid_arg;
+  }
+  napi_value description;
+  if (const auto status = ::napi_create_string_utf8(
+          env, utf8description, length, &description);
+      status != napi_ok) {
+    return status;
+  }
+  napi_value global;
+  if (const auto status = napi_get_global(env, &global); status != napi_ok) {
+    return status;
+  }
+  napi_value symbol;
+  if (const auto status =
+          napi_get_named_property(env, global, "Symbol", &symbol);
+      status != napi_ok) {
+    return status;
+  }
+  napi_value symbolFor;
+  if (const auto status =
+          napi_get_named_property(env, symbol, "for", &symbolFor);
+      status != napi_ok) {
+    return status;
+  }
+  return napi_call_function(env, symbol, symbolFor, 1, &description, result);
+}
+
+napi_status node_api_create_external_string_latin1(napi_env env,
+    char* str,
+    size_t length,
+    node_api_basic_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result,
+    bool* copied) {
+  return createCopiedString(env,
+      str,
+      length,
+      finalize_callback,
+      finalize_hint,
+      result,
+      copied,
+      ::napi_create_string_latin1);
+}
+
+napi_status node_api_create_external_string_utf16(napi_env env,
+    char16_t* str,
+    size_t length,
+    node_api_basic_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result,
+    bool* copied) {
+  return createCopiedString(env,
+      str,
+      length,
+      finalize_callback,
+      finalize_hint,
+      result,
+      copied,
+      ::napi_create_string_utf16);
+}
+
+napi_status node_api_create_property_key_latin1(
+    napi_env env, const char* str, size_t length, napi_value* result) {
+  if (auto* table = getPropertyKeyTable(env)) {
+    return table->latin1(str, length, result);
+  }
+  return ::napi_create_string_latin1(env, str, length, result);
+}
+
+napi_status node_api_create_property_key_utf8(
+    napi_env env, const char* str, size_t length, napi_value* result) {
+  if (auto* table = getPropertyKeyTable(env)) {
+    return table->utf8(str, length, result);
+  }
+  return ::napi_create_string_utf8(env, str, length, result);
+}
+
+napi_status node_api_create_property_key_utf16(
+    napi_env env, const char16_t* str, size_t length, napi_value* result) {
+  if (auto* table = getPropertyKeyTable(env)) {
+    return table->utf16(str, length, result);
+  }
+  return ::napi_create_string_utf16(env, str, length, result);
+}
+
+}  // namespace callstack::nodeapihost
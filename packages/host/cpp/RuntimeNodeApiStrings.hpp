@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Versions.hpp"
+#include "node_api.h"
+
+// String functions of Node-API 9 and 10, implemented by the host on top of
+// the functions of earlier versions, which the runtime implements. Property
+// keys are interned per env, see PropertyKeyTable.
+
+namespace callstack::nodeapihost {
+napi_status node_api_symbol_for(
+    napi_env env, const char* utf8description, size_t length, napi_value* result);
+
+napi_status node_api_create_external_string_latin1(napi_env env,
+    char* str,
+    size_t length,
+    node_api_basic_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result,
+    bool* copied);
+
+napi_status node_api_create_external_string_utf16(napi_env env,
+    char16_t* str,
+    size_t length,
+    node_api_basic_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result,
+    bool* copied);
+
+napi_status node_api_create_property_key_latin1(
+    napi_env env, const char* str, size_t length, napi_value* result);
+
+napi_status node_api_create_property_key_utf8(
+    napi_env env, const char* str, size_t length, napi_value* result);
+
+napi_status node_api_create_property_key_utf16(
+    napi_env env, const char16_t* str, size_t length, napi_value* result);
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,460 @@
+#include "RuntimeNodeApiThreadsafe.hpp"
+#include <ReactCommon/CallInvoker.h>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "BoundedMpscQueue.hpp"
+#include "Logger.hpp"
+#include "RuntimeNodeApiAsync.hpp"
+#include "RuntimeNodeApiLifecycle.hpp"
+
+namespace callstack::nodeapihost {
+namespace {
+// Capacity of the lock-free ring when the queue size is unlimited. Calls
+// exceeding it spill into a mutex protected overflow list.
+constexpr size_t UnlimitedRingCapacity = 1024;
+// Upper bound on the calls dispatched per JS thread hop, leaving room for
+// other work (such as rendering) to interleave with long streams of calls.
+constexpr size_t MaxCallsPerDrain = 1024;
+
+class ThreadsafeFunction
+    : public std::enable_shared_from_this<ThreadsafeFunction> {
+ public:
+  ThreadsafeFunction(napi_env env,
+      napi_ref ref,
+      size_t maxQueueSize,
+      size_t initialThreadCount,
+      void* finalizeData,
+      napi_finalize finalizeCb,
+      void* context,
+      napi_threadsafe_function_call_js callJsCb,
+      std::weak_ptr<facebook::react::CallInvoker> invoker)
+      : env_(env),
+        ref_(ref),
+        maxQueueSize_(maxQueueSize),
+        finalizeData_(finalizeData),
+        finalizeCb_(finalizeCb),
+        context_(context),
+        callJsCb_(callJsCb),
+        invoker_(std::move(invoker)),
+        jsThread_(std::this_thread::get_id()),
+        queue_(maxQueueSize ? maxQueueSize : UnlimitedRingCapacity),
+        threadCount_(initialThreadCount) {}
+
+  static ThreadsafeFunction* fromHandle(napi_threadsafe_function func) {
+    return reinterpret_cast<ThreadsafeFunction*>(func);
+  }
+  napi_threadsafe_function toHandle() {
+    return reinterpret_cast<napi_threadsafe_function>(this);
+  }
+
+  // Keeps the function alive until it is finalized on the JS thread
+  void retainSelf() { self_ = shared_from_this(); }
+
+  void* context() const { return context_; }
+
+  napi_status call(void* data, napi_threadsafe_function_call_mode mode) {
+    if (closing_.load()) {
+      return napi_closing;
+    }
+    if (const auto status = reserve(mode); status != napi_ok) {
+      return status;
+    }
+    push(data);
+    scheduleDrain();
+    return napi_ok;
+  }
+
+  napi_status acquire() {
+    if (closing_.load()) {
+      return napi_closing;
+    }
+    threadCount_.fetch_add(1);
+    return napi_ok;
+  }
+
+  napi_status release(napi_threadsafe_function_release_mode mode) {
+    auto count = threadCount_.load();
+    do {
+      if (count == 0) {
+        return napi_invalid_arg;
+      }
+    } while (!threadCount_.compare_exchange_weak(count, count - 1));
+
+    if (mode == napi_tsfn_abort) {
+      aborted_.store(true);
+      close();
+    }
+    if (forgotten_.load()) {
+      if (count == 1) {
+        releaseSelf();
+      }
+      return napi_ok;
+    }
+    if (count == 1 || mode == napi_tsfn_abort) {
+      // Finalization happens on the JS thread once the queue is drained
+      scheduleDrain();
+    }
+    return napi_ok;
+  }
+
+  // Like Node.js, functions still in use when their env is torn down are
+  // aborted and finalized right away
+  static void tearDown(void* arg) {
+    auto* function = static_cast<ThreadsafeFunction*>(arg);
+    function->aborted_.store(true);
+    function->close();
+    if (!function->finalized_) {
+      function->finalize();
+    }
+  }
+
+  // Aborts functions still in use when their env is forgotten, without
+  // finalizing them, as that would call into the runtime. Calls return
+  // napi_closing from then on, and the function is deleted once the last
+  // thread releases it.
+  static void forget(void* arg) {
+    const auto function =
+        static_cast<ThreadsafeFunction*>(arg)->shared_from_this();
+    function->forgotten_.store(true);
+    function->aborted_.store(true);
+    function->close();
+    if (function->threadCount_.load() == 0) {
+      function->releaseSelf();
+    }
+  }
+
+ private:
+  // Claims a slot in the queue, waiting for one to free up if blocking
+  napi_status reserve(napi_threadsafe_function_call_mode mode) {
+    if (maxQueueSize_ == 0) {
+      size_.fetch_add(1);
+      return napi_ok;
+    }
+    auto size = size_.load();
+    while (true) {
+      if (size < maxQueueSize_) {
+        if (size_.compare_exchange_weak(size, size + 1)) {
+          return napi_ok;
+        }
+        continue;
+      }
+      if (mode == napi_tsfn_nonblocking) {
+        return napi_queue_full;
+      }
+      // Only the JS thread drains the queue, so it would wait forever
+      if (std::this_thread::get_id() == jsThread_) {
+        return napi_would_deadlock;
+      }
+      std::unique_lock lock{spaceMutex_};
+      waiters_.fetch_add(1);
+      spaceCondition_.wait(lock, [this] {
+        return closing_.load() || size_.load() < maxQueueSize_;
+      });
+      waiters_.fetch_sub(1);
+      if (closing_.load()) {
+        return napi_closing;
+      }
+      size = size_.load();
+    }
+  }
+
+  void push(void* data) {
+    if (maxQueueSize_ > 0) {
+      // Reserving a slot guarantees room, as the capacity is >= max queue size
+      [[maybe_unused]] const auto pushed = queue_.tryPush(data);
+      assert(pushed);
+      return;
+    }
+    // Once spilled, calls keep going to the overflow until it's drained, to
+    // preserve the order of calls made from a single thread
+    if (!overflowing_.load() && queue_.tryPush(data)) {
+      return;
+    }
+    std::lock_guard lock{overflowMutex_};
+    overflowing_.store(true);
+    overflow_.push_back(data);
+  }
+
+  bool pop(void*& data) {
+    if (queue_.tryPop(data)) {
+      return true;
+    }
+    if (!overflowing_.load()) {
+      return false;
+    }
+    std::lock_guard lock{overflowMutex_};
+    if (overflow_.empty()) {
+      overflowing_.store(false);
+      return false;
+    }
+    data = overflow_.front();
+    overflow_.pop_front();
+    return true;
+  }
+
+  void popped() {
+    size_.fetch_sub(1);
+    if (waiters_.load() > 0) {
+      std::lock_guard lock{spaceMutex_};
+      spaceCondition_.notify_all();
+    }
+  }
+
+  void close() {
+    closing_.store(true);
+    std::lock_guard lock{spaceMutex_};
+    spaceCondition_.notify_all();
+  }
+
+  void scheduleDrain() {
+    // Coalesces calls into a single hop, until the drain starts
+    if (drainScheduled_.exchange(true)) {
+      return;
+    }
+    const auto invoker = invoker_.lock();
+    if (!invoker) {
+      log_error("No CallInvoker available for threadsafe function");
+      drainScheduled_.store(false);
+      return;
+    }
+    invoker->invokeAsync([self = shared_from_this()]() { self->drain(); });
+  }
+
+  // Runs on the JS thread, dispatching a batch of queued calls
+  void drain() {
+    drainScheduled_.store(false);
+    if (finalized_ || forgotten_.load()) {
+      return;
+    }
+    if (aborted_.load()) {
+      finalize();
+      return;
+    }
+
+    void* data = nullptr;
+    size_t dispatched = 0;
+    while (dispatched < MaxCallsPerDrain && pop(data)) {
+      popped();
+      dispatch(data);
+      dispatched++;
+    }
+
+    // Every call schedules a drain once it's pushed, so only calls left behind
+    // by the batch limit need another hop, not those still being pushed
+    if (dispatched == MaxCallsPerDrain) {
+      scheduleDrain();
+    } else if (threadCount_.load() == 0) {
+      close();
+      finalize();
+    }
+  }
+
+  void dispatch(void* data) {
+    napi_handle_scope scope;
+    if (napi_open_handle_scope(env_, &scope) != napi_ok) {
+      log_error("Failed to open a handle scope for threadsafe function call");
+      return;
+    }
+
+    napi_value func = nullptr;
+    if (ref_) {
+      napi_get_reference_value(env_, ref_, &func);
+    }
+    if (callJsCb_) {
+      callJsCb_(env_, func, context_, data);
+    } else if (func) {
+      napi_value undefined;
+      napi_get_undefined(env_, &undefined);
+      napi_call_function(env_, undefined, func, 0, nullptr, nullptr);
+    }
+
+    bool isExceptionPending = false;
+    napi_is_exception_pending(env_, &isExceptionPending);
+    if (isExceptionPending) {
+      napi_value exception;
+      napi_get_and_clear_last_exception(env_, &exception);
+      log_error("Uncaught exception from threadsafe function call");
+    }
+
+    napi_close_handle_scope(env_, scope);
+  }
+
+  void finalize() {
+    finalized_ = true;
+    ::napi_remove_env_cleanup_hook(env_, tearDown, this);
+    removeHostCleanupHook(env_, forget, this);
+    if (finalizeCb_) {
+      finalizeCb_(env_, finalizeData_, context_);
+    }
+
+    // Like Node.js, calls left behind by an abort are passed without an env
+    // after finalizing, allowing the callback to release their data
+    void* data = nullptr;
+    while (pop(data)) {
+      popped();
+      if (callJsCb_) {
+        callJsCb_(nullptr, nullptr, context_, data);
+      }
+    }
+
+    if (ref_) {
+      napi_delete_reference(env_, ref_);
+      ref_ = nullptr;
+    }
+    releaseSelf();
+  }
+
+  // Might delete this instance, once in-flight drains have returned. Both the
+  // last release and forgetting the env might get here, but only one resets.
+  void releaseSelf() {
+    if (!selfReleased_.exchange(true)) {
+      self_.reset();
+    }
+  }
+
+  const napi_env env_;
+  napi_ref ref_;
+  const size_t maxQueueSize_;
+  void* const finalizeData_;
+  const napi_finalize finalizeCb_;
+  void* const context_;
+  const napi_threadsafe_function_call_js callJsCb_;
+  const std::weak_ptr<facebook::react::CallInvoker> invoker_;
+  // The thread the function was created on, which calls into JS
+  const std::thread::id jsThread_;
+  std::shared_ptr<ThreadsafeFunction> self_;
+  std::atomic<bool> selfReleased_{false};
+
+  BoundedMpscQueue<void*> queue_;
+  // The calls reserved, including those still being pushed, bounding the queue
+  std::atomic<size_t> size_{0};
+  std::atomic<bool> overflowing_{false};
+  std::mutex overflowMutex_;
+  std::deque<void*> overflow_;
+
+  std::mutex spaceMutex_;
+  std::condition_variable spaceCondition_;
+  std::atomic<size_t> waiters_{0};
+
+  std::atomic<size_t> threadCount_;
+  std::atomic<bool> closing_{false};
+  std::atomic<bool> aborted_{false};
+  std::atomic<bool> drainScheduled_{false};
+  // Set once the env is forgotten, when the runtime is gone
+  std::atomic<bool> forgotten_{false};
+  // Only accessed from the JS thread
+  bool finalized_{false};
+};
+}  // anonymous namespace
+
+napi_status napi_create_threadsafe_function(napi_env env,
+    napi_value func,
+    napi_value async_resource,
+    napi_value async_resource_name,
+    size_t max_queue_size,
+    size_t initial_thread_count,
+    void* thread_finalize_data,
+    napi_finalize thread_finalize_cb,
+    void* context,
+    napi_threadsafe_function_call_js call_js_cb,
+    napi_threadsafe_function* result) {
+  if (!env || !async_resource_name || !result || initial_thread_count == 0) {
+    return napi_invalid_arg;
+  }
+  if (!func && !call_js_cb) {
+    return napi_invalid_arg;
+  }
+
+  auto invoker = getCallInvoker(env);
+  if (invoker.expired()) {
+    log_error("No CallInvoker available for threadsafe function");
+    return napi_invalid_arg;
+  }
+
+  napi_ref ref = nullptr;
+  if (func) {
+    if (const auto status = napi_create_reference(env, func, 1, &ref);
+        status != napi_ok) {
+      return status;
+    }
+  }
+
+  const auto function = std::make_shared<ThreadsafeFunction>(env,
+      ref,
+      max_queue_size,
+      initial_thread_count,
+      thread_finalize_data,
+      thread_finalize_cb,
+      context,
+      call_js_cb,
+      std::move(invoker));
+  function->retainSelf();
+  if (const auto status =
+          ::napi_add_env_cleanup_hook(env, ThreadsafeFunction::tearDown,
+              function.get());
+      status != napi_ok) {
+    log_error("Failed to add a cleanup hook for threadsafe function");
+  }
+  addHostCleanupHook(env, ThreadsafeFunction::forget, function.get());
+
+  *result = function->toHandle();
+  return napi_ok;
+}
+
+napi_status napi_get_threadsafe_function_context(
+    napi_threadsafe_function func, void** result) {
+  if (!func || !result) {
+    return napi_invalid_arg;
+  }
+  *result = ThreadsafeFunction::fromHandle(func)->context();
+  return napi_ok;
+}
+
+napi_status napi_call_threadsafe_function(napi_threadsafe_function func,
+    void* data,
+    napi_threadsafe_function_call_mode is_blocking) {
+  if (!func) {
+    return napi_invalid_arg;
+  }
+  return ThreadsafeFunction::fromHandle(func)->call(data, is_blocking);
+}
+
+napi_status napi_acquire_threadsafe_function(napi_threadsafe_function func) {
+  if (!func) {
+    return napi_invalid_arg;
+  }
+  return ThreadsafeFunction::fromHandle(func)->acquire();
+}
+
+napi_status napi_release_threadsafe_function(
+    napi_threadsafe_function func, napi_threadsafe_function_release_mode mode) {
+  if (!func) {
+    return napi_invalid_arg;
+  }
+  return ThreadsafeFunction::fromHandle(func)->release(mode);
+}
+
+// No-ops, as there is no event loop a referenced function could keep alive.
+// Functions live until released or their env is torn down either way.
+napi_status napi_unref_threadsafe_function(
+    node_api_basic_env env, napi_threadsafe_function func) {
+  if (!func) {
+    return napi_invalid_arg;
+  }
+  return napi_ok;
+}
+
+napi_status napi_ref_threadsafe_function(
+    node_api_basic_env env, napi_threadsafe_function func) {
+  if (!func) {
+    return napi_invalid_arg;
+  }
+  return napi_ok;
+}
+
+}  // namespace callstack::nodeapihost
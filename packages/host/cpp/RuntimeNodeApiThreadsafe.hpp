@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Versions.hpp"
+#include "node_api.h"
+
+namespace callstack::nodeapihost {
+napi_status napi_create_threadsafe_function(napi_env env,
+    napi_value func,
+    napi_value async_resource,
+    napi_value async_resource_name,
+    size_t max_queue_size,
+    size_t initial_thread_count,
+    void* thread_finalize_data,
+    napi_finalize thread_finalize_cb,
+    void* context,
+    napi_threadsafe_function_call_js call_js_cb,
+    napi_threadsafe_function* result);
+
+napi_status napi_get_threadsafe_function_context(
+    napi_threadsafe_function func, void** result);
+
+napi_status napi_call_threadsafe_function(napi_threadsafe_function func,
+    void* data,
+    napi_threadsafe_function_call_mode is_blocking);
+
+napi_status napi_acquire_threadsafe_function(napi_threadsafe_function func);
+
+napi_status napi_release_threadsafe_function(
+    napi_threadsafe_function func, napi_threadsafe_function_release_mode mode);
+
+napi_status napi_unref_threadsafe_function(
+    node_api_basic_env env, napi_threadsafe_function func);
+
+napi_status napi_ref_threadsafe_function(
+    node_api_basic_env env, napi_threadsafe_function func);
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,269 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include "Logger.hpp"
+
+#if defined(__APPLE__) || defined(__ANDROID__) || defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace {
+// Same upper bound as libuv's MAX_THREADPOOL_SIZE
+constexpr size_t MaxPoolSize = 1024;
+constexpr size_t MinDefaultPoolSize = 4;
+
+void setCurrentThreadName(const char* name) {
+#if defined(__APPLE__)
+  pthread_setname_np(name);
+#elif defined(__ANDROID__) || defined(__linux__)
+  pthread_setname_np(pthread_self(), name);
+#endif
+}
+
+// The size configured when building the host, or through the environment
+// variable of the same name, which takes precedence like UV_THREADPOOL_SIZE
+size_t getConfiguredPoolSize() {
+  if (const char* value = std::getenv("NODE_API_HOST_THREAD_POOL_SIZE")) {
+    return std::strtoul(value, nullptr, 10);
+  }
+  return NODE_API_HOST_THREAD_POOL_SIZE;
+}
+}  // anonymous namespace
+
+namespace callstack::nodeapihost {
+namespace {
+// The pool and index of the worker running on this thread, if any
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(size_t size) {
+  size = std::clamp<size_t>(size, 1, MaxPoolSize);
+  workers_.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Workers steal from each other, so all of them exist before any starts
+  for (size_t i = 0; i < size; i++) {
+    workers_[i]->thread = std::thread([this, i] {
+      setCurrentThreadName("NodeApiWorker");
+      currentPool = this;
+      currentWorker = i;
+      run(i);
+    });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock{mutex_};
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+ThreadPool::TaskId ThreadPool::submit(Task task, TaskPriority priority) {
+  if (currentPool == this) {
+    const auto id = nextId_.fetch_add(1);
+    auto& worker = *workers_[currentWorker];
+    // Counted before pushing, so the count never falls short of the tasks
+    localTasks_.fetch_add(1);
+    {
+      std::lock_guard lock{worker.mutex};
+      worker.tasks.push_back(QueuedTask{id, Clock::now(), std::move(task)});
+    }
+    // Either this sees a worker going to sleep, or that worker sees the task
+    if (sleepers_.load() > 0) {
+      std::lock_guard lock{mutex_};
+      condition_.notify_one();
+    }
+    return id;
+  }
+
+  TaskId id;
+  {
+    std::lock_guard lock{mutex_};
+    // Taken with the lock held to keep the ids of each queue in order
+    id = nextId_.fetch_add(1);
+    queues_[static_cast<size_t>(priority)].push_back(
+        QueuedTask{id, Clock::now(), std::move(task)});
+  }
+  condition_.notify_one();
+  return id;
+}
+
+bool ThreadPool::cancel(TaskId id, TaskPriority priority) {
+  std::lock_guard lock{mutex_};
+  auto& queue = queues_[static_cast<size_t>(priority)];
+  const auto it = std::lower_bound(queue.begin(),
+      queue.end(),
+      id,
+      [](const QueuedTask& task, TaskId id) { return task.id < id; });
+  if (it == queue.end() || it->id != id) {
+    return false;
+  }
+  queue.erase(it);
+  cancelled_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void ThreadPool::parallelFor(size_t count,
+    const std::function<void(size_t)>& body,
+    TaskPriority priority) {
+  if (count == 0) {
+    return;
+  }
+  // Helpers might only start once the loop is done, so they share ownership
+  // of its state but only call the body for indices they claim
+  struct Loop {
+    const std::function<void(size_t)>* body;
+    size_t count;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+  };
+  const auto loop = std::make_shared<Loop>();
+  loop->body = &body;
+  loop->count = count;
+
+  const auto runIndices = [](Loop& loop) {
+    for (auto index = loop.next.fetch_add(1); index < loop.count;
+         index = loop.next.fetch_add(1)) {
+      (*loop.body)(index);
+      if (loop.done.fetch_add(1) + 1 == loop.count) {
+        loop.done.notify_all();
+      }
+    }
+  };
+
+  const auto helpers = std::min(size(), count - 1);
+  for (size_t i = 0; i < helpers; i++) {
+    submit([loop, runIndices] { runIndices(*loop); }, priority);
+  }
+  runIndices(*loop);
+
+  // Only indices being run by helpers are left
+  for (auto done = loop->done.load(); done < count; done = loop->done.load()) {
+    loop->done.wait(done);
+  }
+}
+
+ThreadPool::Stats ThreadPool::stats() {
+  Stats result;
+  {
+    std::lock_guard lock{mutex_};
+    for (size_t i = 0; i < TaskPriorityCount; i++) {
+      result.queued[i] = queues_[i].size();
+    }
+  }
+  result.started = started_.load(std::memory_order_relaxed);
+  result.stolen = stolen_.load(std::memory_order_relaxed);
+  result.cancelled = cancelled_.load(std::memory_order_relaxed);
+  result.totalWait = std::chrono::nanoseconds(
+      totalWaitNanos_.load(std::memory_order_relaxed));
+  result.maxWait = std::chrono::nanoseconds(
+      maxWaitNanos_.load(std::memory_order_relaxed));
+  return result;
+}
+
+size_t ThreadPool::defaultSize() {
+  return std::max<size_t>(
+      std::thread::hardware_concurrency(), MinDefaultPoolSize);
+}
+
+void ThreadPool::run(size_t index) {
+  while (true) {
+    QueuedTask task;
+    if (popLocal(index, task) || popQueued(task) || steal(index, task)) {
+      started(task);
+      task.task();
+      continue;
+    }
+
+    std::unique_lock lock{mutex_};
+    sleepers_.fetch_add(1);
+    condition_.wait(lock, [this] {
+      return stopping_ || hasQueuedTasks() || localTasks_.load() > 0;
+    });
+    sleepers_.fetch_sub(1);
+    if (stopping_ && !hasQueuedTasks() && localTasks_.load() == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::popLocal(size_t index, QueuedTask& task) {
+  auto& worker = *workers_[index];
+  std::lock_guard lock{worker.mutex};
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  localTasks_.fetch_sub(1);
+  return true;
+}
+
+bool ThreadPool::popQueued(QueuedTask& task) {
+  std::lock_guard lock{mutex_};
+  for (auto& queue : queues_) {
+    if (!queue.empty()) {
+      task = std::move(queue.front());
+      queue.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::steal(size_t thief, QueuedTask& task) {
+  if (localTasks_.load() == 0) {
+    return false;
+  }
+  for (size_t i = 1; i < workers_.size(); i++) {
+    auto& victim = *workers_[(thief + i) % workers_.size()];
+    std::lock_guard lock{victim.mutex};
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      localTasks_.fetch_sub(1);
+      stolen_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::started(const QueuedTask& task) {
+  const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - task.queuedAt)
+                        .count();
+  started_.fetch_add(1, std::memory_order_relaxed);
+  totalWaitNanos_.fetch_add(wait, std::memory_order_relaxed);
+  auto max = maxWaitNanos_.load(std::memory_order_relaxed);
+  while (wait > max && !maxWaitNanos_.compare_exchange_weak(
+                           max, wait, std::memory_order_relaxed)) {
+  }
+}
+
+bool ThreadPool::hasQueuedTasks() const {
+  return std::any_of(queues_.begin(), queues_.end(), [](const auto& queue) {
+    return !queue.empty();
+  });
+}
+
+ThreadPool& getThreadPool() {
+  // Intentionally leaked to avoid joining workers while static destructors run
+  static ThreadPool* pool = [] {
+    const auto size = getConfiguredPoolSize();
+    auto result = new ThreadPool(size ? size : ThreadPool::defaultSize());
+    log_debug("Started thread pool with %zu threads", result->size());
+    return result;
+  }();
+  return *pool;
+}
+
+}  // namespace callstack::nodeapihost
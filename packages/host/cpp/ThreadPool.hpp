@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The number of threads of the shared pool, set when building the host, where
+// 0 uses `ThreadPool::defaultSize()`
+#ifndef NODE_API_HOST_THREAD_POOL_SIZE
+#define NODE_API_HOST_THREAD_POOL_SIZE 0
+#endif
+
+namespace callstack::nodeapihost {
+
+// Queued tasks of a higher priority are started first, in the order they were
+// submitted within a priority
+enum class TaskPriority : uint8_t { UserBlocking, Default, Background };
+constexpr size_t TaskPriorityCount = 3;
+
+/**
+ * A fixed-size pool of worker threads, modelled after the libuv threadpool
+ * Node.js uses to run the `execute` callback of async work off the JS thread,
+ * and shared by everything else the host and addons run in the background.
+ *
+ * Tasks submitted from other threads are queued per priority and can be taken
+ * off the queue until a worker starts them. Tasks submitted by a running task
+ * go to a deque of its worker instead, which the worker runs last in first out
+ * before any queued task, while idle workers steal from the other end. Nested
+ * parallel work thereby stays on the same cores without contending for a
+ * shared queue.
+ */
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+  using TaskId = uint64_t;
+
+  struct Stats {
+    // The number of tasks waiting for a worker, per priority
+    std::array<size_t, TaskPriorityCount> queued{};
+    // Totals since the pool started
+    uint64_t started{0};
+    uint64_t stolen{0};
+    uint64_t cancelled{0};
+    std::chrono::nanoseconds totalWait{0};
+    std::chrono::nanoseconds maxWait{0};
+  };
+
+  explicit ThreadPool(size_t size);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  TaskId submit(Task task, TaskPriority priority = TaskPriority::Default);
+  // Takes a queued task off the queue, returning false if a worker started it
+  // already. Tasks submitted by tasks can't be cancelled.
+  bool cancel(TaskId id, TaskPriority priority);
+
+  // Calls `body` for every index up to `count`, spread over the workers and
+  // the calling thread, returning once all calls returned. As the calling
+  // thread runs indices no worker has picked up, it never waits on queued
+  // tasks and may be a worker itself.
+  void parallelFor(size_t count,
+      const std::function<void(size_t)>& body,
+      TaskPriority priority = TaskPriority::Default);
+
+  Stats stats();
+  size_t size() const { return workers_.size(); }
+
+  // The number of threads used when no size is configured: One per core, but
+  // never less than the 4 threads libuv defaults to.
+  static size_t defaultSize();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct QueuedTask {
+    TaskId id;
+    Clock::time_point queuedAt;
+    Task task;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    // Guarded by the mutex. The owner pushes and pops at the back, thieves
+    // take from the front.
+    std::deque<QueuedTask> tasks;
+    std::thread thread;
+  };
+
+  void run(size_t index);
+  bool popLocal(size_t index, QueuedTask& task);
+  bool popQueued(QueuedTask& task);
+  bool steal(size_t thief, QueuedTask& task);
+  void started(const QueuedTask& task);
+  bool hasQueuedTasks() const;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  // Guarded by the mutex
+  std::array<std::deque<QueuedTask>, TaskPriorityCount> queues_;
+  bool stopping_{false};
+
+  // The number of tasks in the deques of all workers, to wake idle workers
+  std::atomic<size_t> localTasks_{0};
+  std::atomic<size_t> sleepers_{0};
+  std::atomic<TaskId> nextId_{1};
+  std::atomic<uint64_t> started_{0};
+  std::atomic<uint64_t> stolen_{0};
+  std::atomic<uint64_t> cancelled_{0};
+  std::atomic<int64_t> totalWaitNanos_{0};
+  std::atomic<int64_t> maxWaitNanos_{0};
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+// Returns the pool shared by all envs, starting it on first use. Its size is
+// read once then, as the pool is never resized: Preloading addons starts it
+// when the host library loads, before any code of the app runs, so it can only
+// be configured when building the host, or through the environment.
+ThreadPool& getThreadPool();
+
+}  // namespace callstack::nodeapihost
@@ -0,0 +1,101 @@
+#include "Tracing.hpp"
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace callstack::nodeapihost {
+namespace {
+struct TraceEvent {
+  const char* name;
+  std::string addon;
+  int64_t timestamp;  // In microseconds
+  int64_t duration;   // In microseconds
+  uint32_t threadId;
+};
+
+std::mutex eventsMutex;
+std::vector<TraceEvent> events;
+
+// Small, stable numbers are easier to tell apart in trace viewers than the
+// identifiers of the platform
+uint32_t currentThreadId() {
+  static std::atomic<uint32_t> nextThreadId{1};
+  thread_local const uint32_t threadId = nextThreadId.fetch_add(1);
+  return threadId;
+}
+
+int64_t toMicroseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+
+void appendJsonString(std::string& json, const std::string& value) {
+  json += '"';
+  for (const auto c : value) {
+    if (c == '"' || c == '\\') {
+      json += '\\';
+      json += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      json += escaped;
+    } else {
+      json += c;
+    }
+  }
+  json += '"';
+}
+}  // namespace
+
+TraceScope::TraceScope(const char* name, std::string addon)
+    : name_(name),
+      addon_(std::move(addon)),
+      start_(std::chrono::steady_clock::now()) {}
+
+TraceScope::~TraceScope() {
+  const auto end = std::chrono::steady_clock::now();
+  std::lock_guard lock{eventsMutex};
+  if (events.size() < MaxTraceEvents) {
+    events.push_back({
+        .name = name_,
+        .addon = std::move(addon_),
+        .timestamp = toMicroseconds(start_.time_since_epoch()),
+        .duration = toMicroseconds(end - start_),
+        .threadId = currentThreadId(),
+    });
+  }
+}
+
+std::string getTraceEventsJson() {
+  std::lock_guard lock{eventsMutex};
+  const auto processId = static_cast<long long>(getpid());
+  std::string json = "{\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); i++) {
+    const auto& event = events[i];
+    char fields[160];
+    std::snprintf(fields,
+        sizeof(fields),
+        "{\"cat\":\"node-api\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,"
+        "\"pid\":%lld,\"tid\":%u,\"name\":",
+        static_cast<long long>(event.timestamp),
+        static_cast<long long>(event.duration),
+        processId,
+        event.threadId);
+    if (i > 0) {
+      json += ',';
+    }
+    json += fields;
+    appendJsonString(json, event.name);
+    json += ",\"args\":{\"addon\":";
+    appendJsonString(json, event.addon);
+    json += "}}";
+  }
+  json += "]}";
+  return json;
+}
+
+}  // namespace callstack::nodeapihost
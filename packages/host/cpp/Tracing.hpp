@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace callstack::nodeapihost {
+
+/**
+ * Records how long a phase of loading an addon takes, from construction until
+ * destruction, as a "complete" trace event (such as "dlopen" or "init").
+ */
+class TraceScope {
+ public:
+  TraceScope(const char* name, std::string addon);
+  ~TraceScope();
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* name_;
+  std::string addon_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Events recorded beyond this are dropped, bounding the memory of long-running
+// apps loading addons over and over
+constexpr size_t MaxTraceEvents = 4096;
+
+// Returns the recorded events in the Trace Event Format of Chrome, which
+// Perfetto and chrome://tracing load: {"traceEvents": [...]}
+std::string getTraceEventsJson();
+
+}  // namespace callstack::nodeapihost
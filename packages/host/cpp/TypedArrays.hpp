@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include "Versions.hpp"
+#include "node_api.h"
+
+namespace callstack::nodeapihost {
+// The size in bytes of an element of a typed array, or 0 for unknown types
+inline size_t elementSize(napi_typedarray_type type) {
+  switch (type) {
+    case napi_int8_array:
+    case napi_uint8_array:
+    case napi_uint8_clamped_array:
+      return 1;
+    case napi_int16_array:
+    case napi_uint16_array:
+      return 2;
+    case napi_int32_array:
+    case napi_uint32_array:
+    case napi_float32_array:
+      return 4;
+    case napi_float64_array:
+    case napi_bigint64_array:
+    case napi_biguint64_array:
+      return 8;
+    default:
+      return 0;
+  }
+}
+}  // namespace callstack::nodeapihost
@@ -1,3 +1,14 @@
 #pragma once
 
-#define NAPI_VERSION 8
+// The latest Node-API version implemented by the host, as reported by
+// napi_get_version. Declares the functions up to that version, so this header
+// must be included before node_api.h.
+#ifndef NAPI_VERSION
+#define NAPI_VERSION 10
+#elif NAPI_VERSION != 10
+#error "Versions.hpp must be included before node_api.h"
+#endif
+
+// The version of addons not exporting node_api_module_get_api_version_v1,
+// which were built before it was introduced, like Node.js assumes
+#define NODE_API_HOST_DEFAULT_MODULE_VERSION 8
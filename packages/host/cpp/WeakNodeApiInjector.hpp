@@ -1,3 +1,4 @@
+#include "Versions.hpp"
 #include <weak_node_api.hpp>
 
 namespace callstack::nodeapihost {
@@ -1,3 +1,4 @@
+#import "AddonPreloader.hpp"
 #import "CxxNodeApiHostModule.hpp"
 #import "WeakNodeApiInjector.hpp"
 
@@ -23,6 +24,8 @@
 #if USE_CXX_TURBO_MODULE_UTILS
 + (void)load {
   callstack::nodeapihost::injectIntoWeakNodeApi();
+  // Start loading addons while the app is still starting up
+  callstack::nodeapihost::preloadLinkedNodeAddons();
 
   facebook::react::registerCxxModuleToGlobalModuleMap(
       callstack::nodeapihost::CxxNodeApiHostModule::kModuleName,
@@ -0,0 +1,311 @@
+// Headless driver, running CommonJS scripts exercising Node-API addons (such as
+// the tests of the node-addon-examples package) on Hermes, through the host.
+//
+// Usage: node-api-host-driver <script>...
+//
+// A script exporting a function is called and, if it returns a promise, the
+// driver waits for it to settle. The scripts can require "assert" and load
+// addons through "bindings", resolved relative to the script like node-gyp
+// builds them: <script directory>/build/Release/<name>.node
+
+#include <hermes/hermes.h>
+#include <jsi/jsi.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <CxxNodeApiHostModule.hpp>
+#include <WeakNodeApiInjector.hpp>
+
+#include "RunLoop.hpp"
+
+using namespace facebook;
+using callstack::nodeapihost::CxxNodeApiHostModule;
+using callstack::nodeapihost::RunLoop;
+
+namespace {
+
+constexpr auto ScriptTimeout = std::chrono::seconds(60);
+
+// Provides the parts of Node.js the scripts rely on and returns a function
+// running a module factory, which returns an object tracking its completion
+constexpr auto Prelude = R"JS(
+(function (driver) {
+  const format = (args) =>
+    args
+      .map((arg) => {
+        if (typeof arg === "string") return arg;
+        try {
+          return JSON.stringify(arg);
+        } catch {
+          return String(arg);
+        }
+      })
+      .join(" ");
+
+  globalThis.console = {
+    log: (...args) => driver.print(false, format(args)),
+    info: (...args) => driver.print(false, format(args)),
+    debug: (...args) => driver.print(false, format(args)),
+    warn: (...args) => driver.print(true, format(args)),
+    error: (...args) => driver.print(true, format(args)),
+  };
+
+  let nextTimerId = 1;
+  const timers = new Map();
+  globalThis.setTimeout = (callback, delay = 0, ...args) => {
+    const id = nextTimerId++;
+    timers.set(id, () => callback(...args));
+    driver.schedule(() => {
+      const timer = timers.get(id);
+      if (timer) {
+        timers.delete(id);
+        timer();
+      }
+    }, delay);
+    return id;
+  };
+  globalThis.clearTimeout = (id) => timers.delete(id);
+
+  class AssertionError extends Error {
+    constructor(message) {
+      super(message);
+      this.name = "AssertionError";
+    }
+  }
+  const inspect = (value) => format([value]);
+  const fail = (message, fallback) => {
+    throw message instanceof Error
+      ? message
+      : new AssertionError(message === undefined ? fallback : message);
+  };
+  const isDeepStrictEqual = (actual, expected) => {
+    if (Object.is(actual, expected)) return true;
+    if (
+      typeof actual !== "object" ||
+      typeof expected !== "object" ||
+      actual === null ||
+      expected === null ||
+      Object.getPrototypeOf(actual) !== Object.getPrototypeOf(expected)
+    ) {
+      return false;
+    }
+    const keys = Object.keys(actual);
+    return (
+      keys.length === Object.keys(expected).length &&
+      keys.every(
+        (key) =>
+          Object.prototype.hasOwnProperty.call(expected, key) &&
+          isDeepStrictEqual(actual[key], expected[key]),
+      )
+    );
+  };
+
+  const assert = (value, message) => {
+    if (!value) fail(message, "The expression evaluated to a falsy value");
+  };
+  assert.ok = assert;
+  assert.AssertionError = AssertionError;
+  assert.fail = (message) => fail(message, "Failed");
+  assert.strictEqual = (actual, expected, message) => {
+    if (!Object.is(actual, expected)) {
+      fail(message, `Expected ${inspect(actual)} to equal ${inspect(expected)}`);
+    }
+  };
+  assert.notStrictEqual = (actual, expected, message) => {
+    if (Object.is(actual, expected)) {
+      fail(message, `Expected ${inspect(actual)} to not equal itself`);
+    }
+  };
+  assert.deepStrictEqual = (actual, expected, message) => {
+    if (!isDeepStrictEqual(actual, expected)) {
+      fail(message, `Expected ${inspect(actual)} to equal ${inspect(expected)}`);
+    }
+  };
+  assert.throws = (fn, expected, message) => {
+    try {
+      fn();
+    } catch (error) {
+      if (typeof expected === "function" && !(error instanceof expected)) {
+        throw error;
+      }
+      return;
+    }
+    fail(typeof expected === "string" ? expected : message, "Missing expected exception");
+  };
+
+  const builtins = { assert };
+  const createRequire = (dirname) => (id) => {
+    if (id === "bindings") {
+      return (name) =>
+        driver.nodeApiHost.requireNodeAddon(
+          `${dirname}/build/Release/${name.endsWith(".node") ? name : name + ".node"}`,
+        );
+    }
+    if (Object.prototype.hasOwnProperty.call(builtins, id)) {
+      return builtins[id];
+    }
+    throw new Error(`Cannot find module '${id}'`);
+  };
+
+  return (factory, filename, dirname) => {
+    const module = { exports: {} };
+    const result = { state: "pending", error: undefined };
+    const settle = (state, error) => {
+      result.state = state;
+      if (error !== undefined) {
+        result.error = (error && error.stack) || String(error);
+      }
+    };
+    try {
+      factory(module.exports, createRequire(dirname), module, filename, dirname);
+      const value =
+        typeof module.exports === "function" ? module.exports() : undefined;
+      Promise.resolve(value).then(
+        () => settle("fulfilled"),
+        (error) => settle("rejected", error),
+      );
+    } catch (error) {
+      settle("rejected", error);
+    }
+    return result;
+  };
+})
+)JS";
+
+std::shared_ptr<const jsi::Buffer> readScript(const std::filesystem::path& path) {
+  std::ifstream file{path};
+  if (!file) {
+    return nullptr;
+  }
+  std::stringstream source;
+  // Wrapped like Node.js wraps CommonJS modules
+  source << "(function (exports, require, module, __filename, __dirname) {"
+         << file.rdbuf() << "\n})";
+  return std::make_shared<jsi::StringBuffer>(source.str());
+}
+
+jsi::Object createDriverObject(jsi::Runtime& rt,
+    const std::shared_ptr<RunLoop>& runLoop,
+    const std::shared_ptr<CxxNodeApiHostModule>& hostModule) {
+  jsi::Object driver{rt};
+  driver.setProperty(rt,
+      "print",
+      jsi::Function::createFromHostFunction(rt,
+          jsi::PropNameID::forAscii(rt, "print"),
+          2,
+          [](jsi::Runtime& rt,
+              const jsi::Value&,
+              const jsi::Value* args,
+              size_t count) {
+            const auto isError = count > 0 && args[0].getBool();
+            const auto message = count > 1 ? args[1].toString(rt).utf8(rt) : "";
+            std::fprintf(isError ? stderr : stdout, "%s\n", message.c_str());
+            return jsi::Value::undefined();
+          }));
+  driver.setProperty(rt,
+      "schedule",
+      jsi::Function::createFromHostFunction(rt,
+          jsi::PropNameID::forAscii(rt, "schedule"),
+          2,
+          [weakRunLoop = std::weak_ptr{runLoop}](jsi::Runtime& rt,
+              const jsi::Value&,
+              const jsi::Value* args,
+              size_t count) {
+            const auto runLoop = weakRunLoop.lock();
+            if (!runLoop || count < 2) {
+              throw jsi::JSError(rt, "Expected a callback and a delay");
+            }
+            const auto callback =
+                std::make_shared<jsi::Function>(args[0].asObject(rt).asFunction(rt));
+            const auto delay = std::chrono::milliseconds(
+                static_cast<int64_t>(args[1].isNumber() ? args[1].getNumber() : 0));
+            runLoop->schedule(delay,
+                [callback](jsi::Runtime& rt) { callback->call(rt); });
+            return jsi::Value::undefined();
+          }));
+  driver.setProperty(
+      rt, "nodeApiHost", jsi::Object::createFromHostObject(rt, hostModule));
+  return driver;
+}
+
+bool runScript(jsi::Runtime& rt,
+    RunLoop& runLoop,
+    const jsi::Function& runModule,
+    const std::filesystem::path& path) {
+  const auto script = readScript(path);
+  if (!script) {
+    std::fprintf(stderr, "Failed to read %s\n", path.c_str());
+    return false;
+  }
+
+  try {
+    const auto factory =
+        rt.evaluateJavaScript(script, path.string()).asObject(rt).asFunction(rt);
+    const auto result = runModule
+                            .call(rt,
+                                factory,
+                                jsi::String::createFromUtf8(rt, path.string()),
+                                jsi::String::createFromUtf8(
+                                    rt, path.parent_path().string()))
+                            .asObject(rt);
+    const auto state = [&]() {
+      return result.getProperty(rt, "state").asString(rt).utf8(rt);
+    };
+    if (!runLoop.runUntil([&]() { return state() != "pending"; },
+            ScriptTimeout)) {
+      std::fprintf(stderr, "Timed out running %s\n", path.c_str());
+      return false;
+    }
+    if (state() == "rejected") {
+      const auto error = result.getProperty(rt, "error").toString(rt).utf8(rt);
+      std::fprintf(stderr, "%s\n", error.c_str());
+      return false;
+    }
+    return true;
+  } catch (const jsi::JSIException& error) {
+    std::fprintf(stderr, "%s\n", error.what());
+    return false;
+  }
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "Usage: %s <script>...\n", argv[0]);
+    return 2;
+  }
+
+  callstack::nodeapihost::injectIntoWeakNodeApi();
+
+  const auto runtime = facebook::hermes::makeHermesRuntime(
+      ::hermes::vm::RuntimeConfig::Builder().withMicrotaskQueue(true).build());
+  jsi::Runtime& rt = *runtime;
+  const auto runLoop = std::make_shared<RunLoop>(rt);
+  const auto hostModule = std::make_shared<CxxNodeApiHostModule>(runLoop);
+
+  const auto runModule =
+      rt.evaluateJavaScript(std::make_shared<jsi::StringBuffer>(Prelude),
+            "prelude.js")
+          .asObject(rt)
+          .asFunction(rt)
+          .call(rt, createDriverObject(rt, runLoop, hostModule))
+          .asObject(rt)
+          .asFunction(rt);
+
+  int failures = 0;
+  for (int i = 1; i < argc; i++) {
+    const auto path = std::filesystem::absolute(argv[i]);
+    const auto passed = runScript(rt, *runLoop, runModule, path);
+    std::printf("%s %s\n", passed ? "ok" : "not ok", path.c_str());
+    if (!passed) {
+      failures++;
+    }
+  }
+  // Runs the cleanup hooks of the addons while the runtime is still alive
+  hostModule->invalidate();
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#include "RunLoop.hpp"
+
+#include <future>
+
+namespace callstack::nodeapihost {
+
+RunLoop::RunLoop(facebook::jsi::Runtime& runtime)
+    : runtime_(runtime), loopThread_(std::this_thread::get_id()) {}
+
+void RunLoop::invokeAsync(facebook::react::CallFunc&& func) noexcept {
+  {
+    std::lock_guard lock{mutex_};
+    calls_.push_back(std::move(func));
+  }
+  condition_.notify_one();
+}
+
+void RunLoop::invokeSync(facebook::react::CallFunc&& func) {
+  if (std::this_thread::get_id() == loopThread_) {
+    func(runtime_);
+    return;
+  }
+  std::promise<void> done;
+  invokeAsync([&func, &done](facebook::jsi::Runtime& runtime) {
+    try {
+      func(runtime);
+      done.set_value();
+    } catch (...) {
+      done.set_exception(std::current_exception());
+    }
+  });
+  done.get_future().get();
+}
+
+void RunLoop::schedule(Clock::duration delay,
+    facebook::react::CallFunc&& func) {
+  {
+    std::lock_guard lock{mutex_};
+    timers_.emplace(Clock::now() + delay, std::move(func));
+  }
+  condition_.notify_one();
+}
+
+bool RunLoop::runUntil(
+    const std::function<bool()>& isDone, Clock::duration timeout) {
+  const auto deadline = Clock::now() + timeout;
+  while (true) {
+    runtime_.drainMicrotasks();
+    if (isDone()) {
+      return true;
+    }
+
+    std::deque<facebook::react::CallFunc> calls;
+    {
+      std::unique_lock lock{mutex_};
+      const auto wakeUp = timers_.empty()
+                              ? deadline
+                              : std::min(deadline, timers_.begin()->first);
+      condition_.wait_until(lock, wakeUp, [this, wakeUp] {
+        return !calls_.empty() || Clock::now() >= wakeUp;
+      });
+      if (calls_.empty() && Clock::now() >= deadline) {
+        return false;
+      }
+      // Timers are due in the order they were scheduled, as the multimap
+      // preserves insertion order for equal keys
+      const auto now = Clock::now();
+      while (!timers_.empty() && timers_.begin()->first <= now) {
+        calls_.push_back(std::move(timers_.begin()->second));
+        timers_.erase(timers_.begin());
+      }
+      calls.swap(calls_);
+    }
+
+    for (auto& call : calls) {
+      call(runtime_);
+      runtime_.drainMicrotasks();
+    }
+  }
+}
+
+}  // namespace callstack::nodeapihost
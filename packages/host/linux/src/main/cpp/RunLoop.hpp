@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ReactCommon/CallInvoker.h>
+#include <jsi/jsi.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace callstack::nodeapihost {
+
+/**
+ * Stands in for the JS thread of React Native, running calls and timers
+ * on the thread calling `runUntil`.
+ */
+class RunLoop : public facebook::react::CallInvoker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit RunLoop(facebook::jsi::Runtime& runtime);
+
+  using facebook::react::CallInvoker::invokeAsync;
+  using facebook::react::CallInvoker::invokeSync;
+  void invokeAsync(facebook::react::CallFunc&& func) noexcept override;
+  void invokeSync(facebook::react::CallFunc&& func) override;
+
+  // Runs the function on the loop, once the delay has passed
+  void schedule(Clock::duration delay, facebook::react::CallFunc&& func);
+
+  // Runs calls, timers and microtasks until `isDone` returns true, returning
+  // false if that didn't happen before the timeout.
+  // Rethrows exceptions thrown by calls, such as uncaught JS errors.
+  bool runUntil(const std::function<bool()>& isDone, Clock::duration timeout);
+
+ private:
+  facebook::jsi::Runtime& runtime_;
+  std::thread::id loopThread_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<facebook::react::CallFunc> calls_;
+  std::multimap<Clock::time_point, facebook::react::CallFunc> timers_;
+};
+
+}  // namespace callstack::nodeapihost
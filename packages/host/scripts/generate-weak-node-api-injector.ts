@@ -2,7 +2,11 @@ import fs from "node:fs";
 import path from "node:path";
 import cp from "node:child_process";
 
-import { FunctionDecl, getNodeApiFunctions } from "./node-api-functions";
+import {
+  FunctionDecl,
+  getHostExtensionFunctions,
+  getNodeApiFunctions,
+} from "./node-api-functions";
 
 export const CPP_SOURCE_PATH = path.join(__dirname, "../cpp");
 
@@ -17,27 +21,55 @@ const IMPLEMENTED_RUNTIME_FUNCTIONS = [
   "napi_queue_async_work",
   "napi_delete_async_work",
   "napi_cancel_async_work",
+  "napi_create_threadsafe_function",
+  "napi_get_threadsafe_function_context",
+  "napi_call_threadsafe_function",
+  "napi_acquire_threadsafe_function",
+  "napi_release_threadsafe_function",
+  "napi_unref_threadsafe_function",
+  "napi_ref_threadsafe_function",
   "napi_fatal_error",
   "napi_get_node_version",
   "napi_get_version",
+  "node_api_get_module_file_name",
+  "napi_add_env_cleanup_hook",
+  "napi_remove_env_cleanup_hook",
+  "napi_add_async_cleanup_hook",
+  "napi_remove_async_cleanup_hook",
 ];
 
 /**
  * Generates source code which injects the Node API functions from the host.
+ *
+ * Names are resolved within the host's namespace, so engine functions the host
+ * implements itself take precedence over the runtime's. The host implements
+ * all engine functions added after Node-API 8 (the symbol and syntax error
+ * functions of Node-API 9 and the string functions of Node-API 10), so addons
+ * can call them whether or not the runtime implements them.
  */
 export function generateSource(functions: FunctionDecl[]) {
   return `
     // This file is generated by react-native-node-api
     #include <Logger.hpp>
     #include <dlfcn.h>
+    #include <Versions.hpp>
     #include <weak_node_api.hpp>
     #include <RuntimeNodeApi.hpp>
     #include <RuntimeNodeApiAsync.hpp>
+    #include <RuntimeNodeApiErrors.hpp>
+    #include <RuntimeNodeApiFunctions.hpp>
+    #include <RuntimeNodeApiLifecycle.hpp>
+    #include <RuntimeNodeApiObjects.hpp>
+    #include <RuntimeNodeApiStrings.hpp>
+    #include <RuntimeNodeApiStreams.hpp>
+    #include <RuntimeNodeApiThreadsafe.hpp>
     
     #if defined(__APPLE__)
     #define WEAK_NODE_API_LIBRARY_NAME "@rpath/weak-node-api.framework/weak-node-api"
     #elif defined(__ANDROID__)
     #define WEAK_NODE_API_LIBRARY_NAME "libweak-node-api.so"
+    #elif defined(__linux__)
+    #define WEAK_NODE_API_LIBRARY_NAME "libweak-node-api.so"
     #else
     #error "WEAK_NODE_API_LIBRARY_NAME cannot be defined for this platform"
     #endif
@@ -63,7 +95,9 @@ export function generateSource(functions: FunctionDecl[]) {
       ${functions
         .filter(
           ({ kind, name }) =>
-            kind === "engine" || IMPLEMENTED_RUNTIME_FUNCTIONS.includes(name),
+            kind === "engine" ||
+            kind === "host" ||
+            IMPLEMENTED_RUNTIME_FUNCTIONS.includes(name),
         )
         .flatMap(({ name }) => `.${name} = ${name},`)
         .join("\n")}
@@ -74,7 +108,10 @@ export function generateSource(functions: FunctionDecl[]) {
 }
 
 async function run() {
-  const nodeApiFunctions = getNodeApiFunctions();
+  const nodeApiFunctions = [
+    ...getNodeApiFunctions(),
+    ...getHostExtensionFunctions(),
+  ];
 
   const source = generateSource(nodeApiFunctions);
   const sourcePath = path.join(CPP_SOURCE_PATH, "WeakNodeApiInjector.cpp");
@@ -2,7 +2,11 @@ import fs from "node:fs";
 import path from "node:path";
 import cp from "node:child_process";
 
-import { FunctionDecl, getNodeApiFunctions } from "./node-api-functions";
+import {
+  FunctionDecl,
+  getHostExtensionFunctions,
+  getNodeApiFunctions,
+} from "./node-api-functions";
 
 export const WEAK_NODE_API_PATH = path.join(__dirname, "../weak-node-api");
 
@@ -13,8 +17,11 @@ export function generateHeader(functions: FunctionDecl[]) {
   return [
     "// This file is generated by react-native-node-api",
     "#include <node_api.h>", // Node-API
+    "#include <node_api_host.h>", // Extensions implemented by the host
     "#include <stdio.h>", // fprintf()
     "#include <stdlib.h>", // abort()
+    "#include <string.h>", // strcmp()
+    `#include "weak_node_api_profiler.hpp"`, // Counts of calls when profiling
     // Generate the struct of function pointers
     "struct WeakNodeApiHost {",
     ...functions.map(
@@ -26,34 +33,124 @@ export function generateHeader(functions: FunctionDecl[]) {
     "};",
     "typedef void(*InjectHostFunction)(const WeakNodeApiHost&);",
     `extern "C" void inject_weak_node_api_host(const WeakNodeApiHost& host);`,
+    // Allows bypassing the trampolines, to measure their overhead
+    "#if defined(WEAK_NODE_API_BENCHMARKING)",
+    `extern "C" void* weak_node_api_host_function(const char* name);`,
+    "#endif",
   ].join("\n");
 }
 
+/**
+ * Tells if the first argument of a function is the env, to count its calls per env when profiling.
+ */
+function takesEnv({ argumentTypes }: FunctionDecl) {
+  return (
+    argumentTypes[0] === "napi_env" || argumentTypes[0] === "node_api_basic_env"
+  );
+}
+
 /**
  * Generates source code for a version script for the given Node API version.
+ *
+ * By default every call checks that the host injected the function, aborting with a diagnostic if not.
+ * Building with WEAK_NODE_API_DIRECT_BINDING enabled drops that check, leaving a single indirect jump
+ * through the table patched at injection, like calls through a GOT. Debug builds fill the table with stubs
+ * diagnosing calls to functions the host didn't inject instead.
+ *
+ * Building with WEAK_NODE_API_PROFILING enabled counts and samples the calls of every function per env,
+ * by the index of the function in the generated list of names.
+ *
+ * Building with WEAK_NODE_API_BENCHMARKING enabled exports a lookup of the injected functions by name,
+ * letting benchmarks call the host directly. It's left out of other builds, to keep it out of the shipped ABI.
  */
 export function generateSource(functions: FunctionDecl[]) {
+  const withArguments = ({ argumentTypes }: FunctionDecl) =>
+    argumentTypes.map((type, index) => `${type} arg${index}`).join(", ");
+  const declaration = (fn: FunctionDecl, name: string, args: string) =>
+    `${fn.returnType} ${fn.noReturn ? " __attribute__((noreturn))" : ""}${name}(${args})`;
   return [
     "// This file is generated by react-native-node-api",
     `#include "weak_node_api.hpp"`, // Generated header
-    // Generate the struct of function pointers
-    "WeakNodeApiHost g_host;",
+    "",
+    "#if defined(WEAK_NODE_API_DIRECT_BINDING) && !defined(NDEBUG)",
+    "#define WEAK_NODE_API_STUBS 1",
+    "#else",
+    "#define WEAK_NODE_API_STUBS 0",
+    "#endif",
+    "",
+    "[[noreturn, maybe_unused]] static void abort_not_injected(const char* name) {",
+    `  fprintf(stderr, "Node-API function '%s' called before it was injected!\\n", name);`,
+    "  abort();",
+    "}",
+    "",
+    "#if WEAK_NODE_API_STUBS",
+    // Generate stubs standing in for functions not injected (yet)
+    "namespace stubs {",
+    ...functions.map(
+      (fn) =>
+        `static ${declaration(fn, fn.name, fn.argumentTypes.join(", "))} { abort_not_injected("${fn.name}"); }`,
+    ),
+    "} // namespace stubs",
+    "",
+    // Generate the struct of function pointers, internal to address it without going through the GOT
+    "static WeakNodeApiHost g_host = {",
+    ...functions.map(({ name }) => `  stubs::${name},`),
+    "};",
+    "#else",
+    "static WeakNodeApiHost g_host;",
+    "#endif",
+    "",
     "void inject_weak_node_api_host(const WeakNodeApiHost& host) {",
     "  g_host = host;",
+    "#if WEAK_NODE_API_STUBS",
+    ...functions.map(
+      ({ name }) =>
+        `  if (g_host.${name} == nullptr) g_host.${name} = stubs::${name};`,
+    ),
+    "#endif",
+    "};",
+    ``,
+    // Generate the lookup of host functions by name
+    "#if defined(WEAK_NODE_API_BENCHMARKING)",
+    "#if WEAK_NODE_API_STUBS",
+    "#define HOST_FUNCTION(name) (reinterpret_cast<void*>(g_host.name) == reinterpret_cast<void*>(stubs::name) ? nullptr : reinterpret_cast<void*>(g_host.name))",
+    "#else",
+    "#define HOST_FUNCTION(name) reinterpret_cast<void*>(g_host.name)",
+    "#endif",
+    "void* weak_node_api_host_function(const char* name) {",
+    ...functions.map(
+      ({ name }) =>
+        `  if (strcmp(name, "${name}") == 0) return HOST_FUNCTION(${name});`,
+    ),
+    "  return nullptr;",
     "};",
+    "#endif",
+    ``,
+    "#if defined(WEAK_NODE_API_DIRECT_BINDING)",
+    "#define CHECK_INJECTED(name)",
+    "#else",
+    "#define CHECK_INJECTED(name) if (g_host.name == nullptr) abort_not_injected(#name);",
+    "#endif",
+    ``,
+    "#if defined(WEAK_NODE_API_PROFILING)",
+    "namespace weak_node_api_profiler {",
+    "const char* const functionNames[] = {",
+    ...functions.map(({ name }) => `  "${name}",`),
+    "};",
+    `const size_t functionCount = ${functions.length};`,
+    "} // namespace weak_node_api_profiler",
+    "#define PROFILE_CALL(function, env) weak_node_api_profiler::Call profiled_call{function, env};",
+    "#else",
+    "#define PROFILE_CALL(function, env)",
+    "#endif",
     ``,
     // Generate function calling into the host
-    ...functions.flatMap(({ returnType, noReturn, name, argumentTypes }) => {
+    ...functions.flatMap((fn, index) => {
+      const { returnType, name, argumentTypes } = fn;
       return [
-        `extern "C" ${returnType} ${
-          noReturn ? " __attribute__((noreturn))" : ""
-        }${name}(${argumentTypes
-          .map((type, index) => `${type} arg${index}`)
-          .join(", ")}) {`,
-        `if (g_host.${name} == nullptr) {`,
-        `  fprintf(stderr, "Node-API function '${name}' called before it was injected!\\n");`,
-        "  abort();",
-        "}",
+        `extern "C" ${declaration(fn, name, withArguments(fn))} {`,
+        `CHECK_INJECTED(${name})`,
+        `PROFILE_CALL(${index}, ${takesEnv(fn) ? "arg0" : "nullptr"})`,
         (returnType === "void" ? "" : "return ") +
           "g_host." +
           name +
@@ -69,7 +166,10 @@ export function generateSource(functions: FunctionDecl[]) {
 async function run() {
   await fs.promises.mkdir(WEAK_NODE_API_PATH, { recursive: true });
 
-  const nodeApiFunctions = getNodeApiFunctions();
+  const nodeApiFunctions = [
+    ...getNodeApiFunctions(),
+    ...getHostExtensionFunctions(),
+  ];
 
   const header = generateHeader(nodeApiFunctions);
   const headerPath = path.join(WEAK_NODE_API_PATH, "weak_node_api.hpp");
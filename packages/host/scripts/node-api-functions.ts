@@ -24,11 +24,25 @@ const clangAstDump = z.object({
   ),
 });
 
+/**
+ * Declares the extensions of Node-API implemented by the host.
+ */
+export const HOST_EXTENSIONS_HEADER_PATH = path.join(
+  __dirname,
+  "../weak-node-api/node_api_host.h",
+);
+
+const HOST_EXTENSION_PREFIX = "node_api_host_";
+
 /**
  * Generates source code for a version script for the given Node API version.
  * @param version
+ * @param headerPath The header to parse, which includes the Node API headers
  */
-export function getNodeApiHeaderAST(version: NodeApiVersion) {
+export function getNodeApiHeaderAST(
+  version: NodeApiVersion,
+  headerPath = path.join(nodeApiIncludePath, "node_api.h"),
+) {
   const output = cp.execFileSync(
     "clang",
     [
@@ -43,7 +57,7 @@ export function getNodeApiHeaderAST(version: NodeApiVersion) {
       "-fsyntax-only",
       // Include from the node-api-headers package
       `-I${nodeApiIncludePath}`,
-      path.join(nodeApiIncludePath, "node_api.h"),
+      headerPath,
     ],
     {
       encoding: "utf-8",
@@ -57,7 +71,7 @@ export function getNodeApiHeaderAST(version: NodeApiVersion) {
 
 export type FunctionDecl = {
   name: string;
-  kind: "engine" | "runtime";
+  kind: "engine" | "runtime" | "host";
   returnType: string;
   noReturn: boolean;
   argumentTypes: string[];
@@ -65,7 +79,47 @@ export type FunctionDecl = {
   fallbackReturnStatement: string;
 };
 
-export function getNodeApiFunctions(version: NodeApiVersion = "v8") {
+function toFunctionDecl(
+  node: z.infer<typeof clangAstDump>["inner"][number],
+  kind: FunctionDecl["kind"],
+): FunctionDecl {
+  const { name } = node;
+  assert(name, "Expected a name");
+  assert(node.type, `Expected type for ${node.name}`);
+
+  const match = node.type.qualType.match(
+    /^(?<returnType>[^(]+) \((?<argumentTypes>[^)]+)\)/,
+  );
+  assert(
+    match && match.groups,
+    `Failed to parse function type: ${node.type.qualType}`,
+  );
+  const { returnType, argumentTypes } = match.groups;
+  assert(returnType, `Failed to get return type from ${node.type.qualType}`);
+  assert(argumentTypes, `Failed to get argument types from ${argumentTypes}`);
+  assert(
+    returnType === "napi_status" || returnType === "void",
+    `Expected return type to be napi_status, got ${returnType}`,
+  );
+
+  return {
+    name,
+    returnType,
+    noReturn: node.type.qualType.includes("__attribute__((noreturn))"),
+    kind,
+    argumentTypes: argumentTypes
+      .split(",")
+      .map((arg) => arg.trim().replace("_Bool", "bool")),
+    // Defer to the right library
+    libraryPath: kind === "engine" ? "libhermes.so" : "libnode-api-host.so",
+    fallbackReturnStatement:
+      returnType === "void"
+        ? "abort();"
+        : "return napi_status::napi_generic_failure;",
+  };
+}
+
+export function getNodeApiFunctions(version: NodeApiVersion = "v10") {
   const root = getNodeApiHeaderAST(version);
   assert.equal(root.kind, "TranslationUnitDecl");
   assert(Array.isArray(root.inner));
@@ -81,48 +135,10 @@ export function getNodeApiFunctions(version: NodeApiVersion = "v8") {
   for (const node of root.inner) {
     const { name, kind } = node;
     if (kind === "FunctionDecl" && name && allSymbols.has(name)) {
-      assert(name, "Expected a name");
       foundSymbols.add(name);
-      assert(node.type, `Expected type for ${node.name}`);
-
-      const match = node.type.qualType.match(
-        /^(?<returnType>[^(]+) \((?<argumentTypes>[^)]+)\)/,
-      );
-      assert(
-        match && match.groups,
-        `Failed to parse function type: ${node.type.qualType}`,
-      );
-      const { returnType, argumentTypes } = match.groups;
-      assert(
-        returnType,
-        `Failed to get return type from ${node.type.qualType}`,
-      );
-      assert(
-        argumentTypes,
-        `Failed to get argument types from ${argumentTypes}`,
-      );
-      assert(
-        returnType === "napi_status" || returnType === "void",
-        `Expected return type to be napi_status, got ${returnType}`,
+      nodeApiFunctions.push(
+        toFunctionDecl(node, engineSymbols.has(name) ? "engine" : "runtime"),
       );
-
-      nodeApiFunctions.push({
-        name,
-        returnType,
-        noReturn: node.type.qualType.includes("__attribute__((noreturn))"),
-        kind: engineSymbols.has(name) ? "engine" : "runtime",
-        argumentTypes: argumentTypes
-          .split(",")
-          .map((arg) => arg.trim().replace("_Bool", "bool")),
-        // Defer to the right library
-        libraryPath: engineSymbols.has(name)
-          ? "libhermes.so"
-          : "libnode-api-host.so",
-        fallbackReturnStatement:
-          returnType === "void"
-            ? "abort();"
-            : "return napi_status::napi_generic_failure;",
-      });
     }
   }
   for (const knownSymbol of allSymbols) {
@@ -135,3 +151,16 @@ export function getNodeApiFunctions(version: NodeApiVersion = "v8") {
 
   return nodeApiFunctions;
 }
+
+/**
+ * Gets the extensions of Node-API declared in the header of the host.
+ */
+export function getHostExtensionFunctions(version: NodeApiVersion = "v10") {
+  const root = getNodeApiHeaderAST(version, HOST_EXTENSIONS_HEADER_PATH);
+  return root.inner
+    .filter(
+      ({ kind, name }) =>
+        kind === "FunctionDecl" && name?.startsWith(HOST_EXTENSION_PREFIX),
+    )
+    .map((node) => toFunctionDecl(node, "host"));
+}
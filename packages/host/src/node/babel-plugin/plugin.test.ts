@@ -6,6 +6,7 @@ import { transformFileSync } from "@babel/core";
 
 import { plugin, PluginOptions } from "./plugin.js";
 import { setupTempDirectory } from "../test-utils.js";
+import { createLazyExports } from "../../react-native/lazy-exports.js";
 
 type TestTransformationOptions = {
   files: Record<string, string>;
@@ -126,6 +127,23 @@ describe("plugin", () => {
       });
     });
 
+    itTransforms("a simple call into a lazy binding", {
+      files: {
+        "package.json": `{ "name": "my-package" }`,
+        "my-addon.apple.node/my-addon.node":
+          "// This is supposed to be a binary file",
+        "index.js": `
+          const addon = require('./my-addon.node');
+          console.log(addon);
+        `,
+      },
+      inputFilePath: "index.js",
+      options: { lazy: true },
+      assertion: assertIncludes(
+        `requireNodeAddonLazily("my-package--my-addon")`,
+      ),
+    });
+
     itTransforms("and does not touch required JS files", {
       files: {
         "package.json": `{ "name": "my-package" }`,
@@ -156,6 +174,23 @@ describe("plugin", () => {
       assertion: assertIncludes(`requireNodeAddon("my-package--my-addon")`),
     });
 
+    itTransforms("a simple call into a lazy binding", {
+      files: {
+        "package.json": `{ "name": "my-package" }`,
+        "my-addon.apple.node/my-addon.node":
+          "// This is supposed to be a binary file",
+        "index.js": `
+          const addon = require('bindings')('my-addon');
+          console.log(addon);
+        `,
+      },
+      inputFilePath: "index.js",
+      options: { lazy: true },
+      assertion: assertIncludes(
+        `requireNodeAddonLazily("my-package--my-addon")`,
+      ),
+    });
+
     describe("in 'build/Release'", () => {
       itTransforms("a nested addon (keeping suffix)", {
         files: {
@@ -205,4 +240,75 @@ describe("plugin", () => {
       });
     });
   });
+
+  describe("evaluating lazy bindings", () => {
+    // Transforms and evaluates a module requiring an addon lazily, against a
+    // host which counts the loads of the addon
+    function evaluateLazily(
+      context: TestContext,
+      code: string,
+      addonExports: unknown,
+    ) {
+      const tempDirectoryPath = setupTempDirectory(context, {
+        "package.json": `{ "name": "my-package" }`,
+        "my-addon.apple.node/my-addon.node":
+          "// This is supposed to be a binary file",
+        "index.js": code,
+      });
+      const result = transformFileSync(
+        path.join(tempDirectoryPath, "index.js"),
+        { plugins: [[plugin, { lazy: true }]] },
+      );
+      assert(result?.code, "Expected transformation to produce code");
+
+      const loads: string[] = [];
+      const host = {
+        requireNodeAddonLazily: (libraryName: string) =>
+          createLazyExports(() => {
+            loads.push(libraryName);
+            return addonExports;
+          }),
+      };
+      const module = { exports: {} as Record<string, unknown> };
+      const require = (id: string) => {
+        assert.equal(id, "react-native-node-api");
+        return host;
+      };
+      new Function("require", "module", result.code)(require, module);
+      return { exports: module.exports, loads };
+    }
+
+    it("loads the addon on first property access", async (context) => {
+      const { exports, loads } = evaluateLazily(
+        context,
+        `module.exports.addon = require('./my-addon.node');`,
+        { add: (a: number, b: number) => a + b },
+      );
+      const addon = exports.addon as { add(a: number, b: number): number };
+      assert.deepEqual(loads, []);
+
+      // Probed by module interop and promise resolution
+      assert.equal((addon as Record<string, unknown>).__esModule, undefined);
+      assert.equal(await Promise.resolve(addon), addon);
+      assert.equal(Object.prototype.toString.call(addon), "[object Function]");
+      assert.deepEqual(loads, []);
+
+      assert.equal(addon.add(1, 2), 3);
+      assert.equal("add" in addon, true);
+      assert.deepEqual(Object.keys(addon), ["add"]);
+      assert.deepEqual(loads, ["my-package--my-addon"]);
+    });
+
+    it("calls an addon exporting a function", (context) => {
+      const { exports, loads } = evaluateLazily(
+        context,
+        `module.exports.addon = require('./my-addon.node');`,
+        (a: number, b: number) => a + b,
+      );
+      const addon = exports.addon as (a: number, b: number) => number;
+      assert.deepEqual(loads, []);
+      assert.equal(addon(1, 2), 3);
+      assert.deepEqual(loads, ["my-package--my-addon"]);
+    });
+  });
 });
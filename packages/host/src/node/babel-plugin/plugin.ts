@@ -24,6 +24,10 @@ export type PluginOptions = {
    * - `"keep"`: The full path is kept and the library name will be `my-pkg--build-Release-my-addon`.
    */
   pathSuffix?: PathSuffixChoice;
+  /**
+   * Emits bindings which only require the addon when first accessed or called, instead of when the requiring module is evaluated.
+   */
+  lazy?: boolean;
 };
 
 function assertOptions(opts: unknown): asserts opts is PluginOptions {
@@ -31,12 +35,16 @@ function assertOptions(opts: unknown): asserts opts is PluginOptions {
   if ("pathSuffix" in opts) {
     assertPathSuffix(opts.pathSuffix);
   }
+  if ("lazy" in opts) {
+    assert(typeof opts.lazy === "boolean", "Expected 'lazy' to be a boolean");
+  }
 }
 
 export function replaceWithRequireNodeAddon(
   p: NodePath,
   modulePath: string,
   naming: NamingStrategy,
+  lazy = false,
 ) {
   const requireCallArgument = getLibraryName(modulePath, naming);
   p.replaceWith(
@@ -45,7 +53,7 @@ export function replaceWithRequireNodeAddon(
         t.callExpression(t.identifier("require"), [
           t.stringLiteral("react-native-node-api"),
         ]),
-        t.identifier("requireNodeAddon"),
+        t.identifier(lazy ? "requireNodeAddonLazily" : "requireNodeAddon"),
       ),
       [t.stringLiteral(requireCallArgument)],
     ),
@@ -57,7 +65,7 @@ export function plugin(): PluginObj {
     visitor: {
       CallExpression(p) {
         assertOptions(this.opts);
-        const { pathSuffix = "strip" } = this.opts;
+        const { pathSuffix = "strip", lazy = false } = this.opts;
         if (typeof this.filename !== "string") {
           // This transformation only works when the filename is known
           return;
@@ -79,9 +87,12 @@ export function plugin(): PluginObj {
               const id = argument.value;
               const resolvedPath = findNodeAddonForBindings(id, from);
               if (typeof resolvedPath === "string") {
-                replaceWithRequireNodeAddon(p.parentPath, resolvedPath, {
-                  pathSuffix,
-                });
+                replaceWithRequireNodeAddon(
+                  p.parentPath,
+                  resolvedPath,
+                  { pathSuffix },
+                  lazy,
+                );
               }
             }
           } else if (
@@ -89,7 +100,12 @@ export function plugin(): PluginObj {
             isNodeApiModule(path.join(from, id))
           ) {
             const relativePath = path.join(from, id);
-            replaceWithRequireNodeAddon(p, relativePath, { pathSuffix });
+            replaceWithRequireNodeAddon(
+              p,
+              relativePath,
+              { pathSuffix },
+              lazy,
+            );
           }
         }
       },
@@ -49,7 +49,7 @@ export type ModuleOutputBase = {
 
 type ModuleOutput = ModuleOutputBase &
   (
-    | { outputPath: string; failure?: never }
+    | { outputPath: string; libraryName: string; failure?: never }
     | { outputPath?: never; failure: SpawnFailure }
   );
 
@@ -130,6 +130,35 @@ export async function pruneLinkedModules(
   );
 }
 
+/**
+ * Writes the names of the libraries the host loads as the app starts, included
+ * by its native code as a list of string literals.
+ * The file is only written when its contents change, to skip needless rebuilds.
+ */
+export async function writePreloadedLibraryNames(
+  platform: PlatformName,
+  libraryNames: string[],
+) {
+  const preloadPath = getPreloadPath(platform);
+  const contents = libraryNames
+    .map((libraryName) => JSON.stringify(libraryName) + ",\n")
+    .join("");
+  const existingContents = fs.existsSync(preloadPath)
+    ? await fs.promises.readFile(preloadPath, "utf8")
+    : undefined;
+  if (contents !== existingContents) {
+    await fs.promises.writeFile(preloadPath, contents, "utf8");
+  }
+}
+
+export function getPreloadPath(platform: PlatformName) {
+  // Next to the linked libraries, as Gradle uses every entry of their directory
+  return path.join(
+    path.dirname(getAutolinkPath(platform)),
+    `${platform}-preload.inc`,
+  );
+}
+
 export function hasDuplicateLibraryNames(
   modulePaths: string[],
   naming: NamingStrategy,
@@ -2,7 +2,7 @@ import { Option } from "@commander-js/extra-typings";
 
 import { assertPathSuffix, PATH_SUFFIX_CHOICES } from "../path-utils";
 
-const { NODE_API_PATH_SUFFIX } = process.env;
+const { NODE_API_PATH_SUFFIX, NODE_API_PRELOAD } = process.env;
 if (typeof NODE_API_PATH_SUFFIX === "string") {
   assertPathSuffix(NODE_API_PATH_SUFFIX);
 }
@@ -13,3 +13,8 @@ export const pathSuffixOption = new Option(
 )
   .choices(PATH_SUFFIX_CHOICES)
   .default(NODE_API_PATH_SUFFIX || "strip");
+
+export const preloadOption = new Option(
+  "--preload",
+  "Load the linked libraries on background threads as the app starts, ahead of them being required",
+).default(NODE_API_PRELOAD === "true");
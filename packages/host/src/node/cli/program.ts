@@ -20,8 +20,13 @@ import {
 } from "../path-utils";
 
 import { command as vendorHermes } from "./hermes";
-import { pathSuffixOption } from "./options";
-import { linkModules, pruneLinkedModules, ModuleLinker } from "./link-modules";
+import { pathSuffixOption, preloadOption } from "./options";
+import {
+  linkModules,
+  pruneLinkedModules,
+  writePreloadedLibraryNames,
+  ModuleLinker,
+} from "./link-modules";
 import { linkXcframework } from "./apple";
 import { linkAndroidDir } from "./android";
 
@@ -68,7 +73,9 @@ program
   .option("--android", "Link Android modules")
   .option("--apple", "Link Apple modules")
   .addOption(pathSuffixOption)
-  .action(async (pathArg, { force, prune, pathSuffix, android, apple }) => {
+  .addOption(preloadOption)
+  .action(async (pathArg, options) => {
+    const { force, prune, pathSuffix, preload, android, apple } = options;
     console.log("Auto-linking Node-API modules from", chalk.dim(pathArg));
     const platforms: PlatformName[] = [];
     if (android) {
@@ -158,6 +165,11 @@ program
       if (prune) {
         await pruneLinkedModules(platform, modules);
       }
+
+      await writePreloadedLibraryNames(
+        platform,
+        preload ? linked.map(({ libraryName }) => libraryName) : [],
+      );
     }
   });
 
@@ -1,8 +1,35 @@
 import type { TurboModule } from "react-native";
 import { TurboModuleRegistry } from "react-native";
 
+export type NodeApiProfileEntry = {
+  /** The addon calling the function, null for functions not taking an env */
+  addon: string | null;
+  function: string;
+  calls: number;
+  /** The calls which were timed, a sample of all calls */
+  sampledCalls: number;
+  sampledNs: number;
+  /** The number of timed calls per bit width of their duration in nanoseconds */
+  histogram: number[];
+};
+
 export interface Spec extends TurboModule {
-  requireNodeAddon(libraryName: string): void;
+  requireNodeAddon(libraryName: string): unknown;
+  /**
+   * Loads the library of an addon on a background thread, resolving with its
+   * exports once initialized on the JS thread.
+   */
+  requireNodeAddonAsync(libraryName: string): Promise<unknown>;
+  /**
+   * Returns the timings of loading and initializing addons, as JSON in the
+   * Trace Event Format, which https://ui.perfetto.dev and chrome://tracing load.
+   */
+  getTraceEvents(): string;
+  /**
+   * Returns the calls addons made through weak-node-api per function, or null
+   * unless weak-node-api was built with WEAK_NODE_API_PROFILING enabled.
+   */
+  getNodeApiProfile(reset?: boolean): NodeApiProfileEntry[] | null;
 }
 
 export default TurboModuleRegistry.getEnforcing<Spec>("NodeApiHost");
@@ -1,5 +1,29 @@
 import native from "./NativeNodeApiHost";
+import { createLazyExports } from "./lazy-exports";
 
-const { requireNodeAddon } = native;
+export type { NodeApiProfileEntry } from "./NativeNodeApiHost";
 
-export { requireNodeAddon };
+const {
+  requireNodeAddon,
+  requireNodeAddonAsync,
+  getTraceEvents,
+  getNodeApiProfile,
+} = native;
+
+/**
+ * Returns a stand-in for the exports of an addon, which only requires the
+ * addon when a property is first accessed or it's first called. Like
+ * `requireNodeAddon`, the host loads the addon once and initializes it once
+ * per runtime.
+ */
+function requireNodeAddonLazily(libraryName: string): object {
+  return createLazyExports(() => requireNodeAddon(libraryName));
+}
+
+export {
+  requireNodeAddon,
+  requireNodeAddonLazily,
+  requireNodeAddonAsync,
+  getTraceEvents,
+  getNodeApiProfile,
+};
@@ -0,0 +1,44 @@
+// Keys probed by module interop and promise resolution, such as when a module
+// re-exports the stand-in or returns it from an async function
+const PROBED_KEYS = new Set<PropertyKey>(["__esModule", "then"]);
+
+/**
+ * Returns a stand-in for the exports returned by `load`, which is only called
+ * when the stand-in is first used as the exports: When one of their properties
+ * is accessed, or when they're called as a function. Probing the stand-in for
+ * interop keys or symbols doesn't load the exports.
+ */
+export function createLazyExports(load: () => unknown): object {
+  let exports: object | undefined;
+  const getExports = () => {
+    if (exports === undefined) {
+      exports = load() as object;
+    }
+    return exports;
+  };
+  // An arrow function can be called, while having no non-configurable own
+  // properties the traps would have to report
+  return new Proxy(() => {}, {
+    get(_, key) {
+      const probed = typeof key === "symbol" || PROBED_KEYS.has(key);
+      if (exports === undefined && probed) {
+        return undefined;
+      }
+      return Reflect.get(getExports(), key);
+    },
+    set: (_, key, value) => Reflect.set(getExports(), key, value),
+    has: (_, key) => Reflect.has(getExports(), key),
+    deleteProperty: (_, key) => Reflect.deleteProperty(getExports(), key),
+    defineProperty: (_, key, descriptor) =>
+      Reflect.defineProperty(getExports(), key, descriptor),
+    ownKeys: () => Reflect.ownKeys(getExports()),
+    getOwnPropertyDescriptor(_, key) {
+      const descriptor = Reflect.getOwnPropertyDescriptor(getExports(), key);
+      // Properties missing on the target must be reported as configurable
+      return descriptor && { ...descriptor, configurable: true };
+    },
+    getPrototypeOf: () => Reflect.getPrototypeOf(getExports()),
+    apply: (_, thisArg, args) =>
+      Reflect.apply(getExports() as () => unknown, thisArg, args),
+  });
+}
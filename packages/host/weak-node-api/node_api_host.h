@@ -0,0 +1,218 @@
+#ifndef NODE_API_HOST_H_
+#define NODE_API_HOST_H_
+
+// Extensions of Node-API implemented by react-native-node-api, which addons
+// linking against weak-node-api can call like any other Node-API function.
+// They aren't available when running in Node.js.
+
+#include <node_api.h>
+#include <stddef.h>
+#include <stdint.h>
+
+EXTERN_C_START
+
+// The type of a field of the records passed to
+// node_api_host_create_object_array, and of the property created from it
+typedef enum {
+  node_api_host_field_bool,     // bool, to a boolean
+  node_api_host_field_int32,    // int32_t, to a number
+  node_api_host_field_uint32,   // uint32_t, to a number
+  node_api_host_field_int64,    // int64_t, to a number (losing precision)
+  node_api_host_field_double,   // double, to a number
+  node_api_host_field_bigint64, // int64_t, to a BigInt
+  node_api_host_field_string,   // const char*, UTF-8 and NUL terminated, to a
+                                // string or null if NULL
+} node_api_host_field_type;
+
+// Describes a field of the records passed to
+// node_api_host_create_object_array, usually laid out by a C struct
+typedef struct {
+  // The name of the property, UTF-8 and NUL terminated
+  const char* name;
+  node_api_host_field_type type;
+  // The offset of the field within a record, as returned by `offsetof`
+  size_t offset;
+} node_api_host_field;
+
+// Creates an array of `record_count` objects in a single call, each with a
+// property per field read from the records, which are `record_size` bytes
+// apart in `records`. The objects share their shape, with the properties
+// defined in the order of the fields.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_create_object_array(napi_env env,
+                                  const node_api_host_field* fields,
+                                  size_t field_count,
+                                  const void* records,
+                                  size_t record_size,
+                                  size_t record_count,
+                                  napi_value* result);
+
+// A ring buffer written by native code and read from JS, for continuous
+// feeds of data such as sensor readings or audio samples
+typedef struct node_api_host_stream__* node_api_host_stream;
+
+// Creates a stream of `capacity` elements of the given type. Written elements
+// are passed to `callback` on the JS thread, as arguments:
+// - A typed array viewing the entire ring buffer, the same for every call.
+// - The index of the first written element in the view.
+// - The number of written elements, continuing from the start of the view
+//   past its end.
+// The elements are only valid until the callback returns. Writes made before
+// the callback is called are passed in a single call, and the callbacks of
+// all streams of an env are called in a single hop to the JS thread.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_create_stream(napi_env env,
+                            napi_typedarray_type type,
+                            size_t capacity,
+                            napi_value callback,
+                            node_api_host_stream* result);
+
+// Copies up to `count` elements into the stream, as many as fit the space not
+// yet read from JS, returning the number of elements copied in `written`.
+// Can be called from any thread, but only one thread at a time. Returns
+// napi_closing once the env is torn down, after which the stream must still be
+// released.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_stream_write(node_api_host_stream stream,
+                           const void* data,
+                           size_t count,
+                           size_t* written);
+
+// Releases the stream once done writing to it. Elements already written are
+// still passed to the callback, after which the stream is deleted.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_release_stream(node_api_host_stream stream);
+
+// The priority of async work, deciding which queued work the threads of the
+// host execute first. Work of the same priority is executed in queue order.
+typedef enum {
+  node_api_host_priority_user_blocking, // Work someone is waiting for
+  node_api_host_priority_default,       // Work created without a priority
+  node_api_host_priority_background,    // Work nobody is waiting for, such as
+                                        // prefetching
+} node_api_host_priority;
+
+// Sets the priority of async work, taking effect when it's queued next
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_set_async_work_priority(napi_env env,
+                                      napi_async_work work,
+                                      node_api_host_priority priority);
+
+// Sets the priority of async work created in the env from now on
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_set_default_async_work_priority(napi_env env,
+                                              node_api_host_priority priority);
+
+// Counters of the threads executing async work, shared by all envs
+typedef struct {
+  // The number of jobs waiting for a thread, per priority
+  size_t queued_user_blocking;
+  size_t queued_default;
+  size_t queued_background;
+  // Totals since the threads started: The number of jobs started and of jobs
+  // cancelled while queued, and the time the started jobs waited in the queue
+  uint64_t started;
+  uint64_t cancelled;
+  uint64_t total_wait_ns;
+  uint64_t max_wait_ns;
+} node_api_host_async_work_stats;
+
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_get_async_work_stats(napi_env env,
+                                   node_api_host_async_work_stats* result);
+
+// Sets how long the JS thread may spend calling the `complete` callbacks of
+// async work of the env in a row, 4 ms by default. The callbacks of jobs
+// finishing close together are called in a single task, which yields the JS
+// thread once out of budget and continues with the remaining callbacks in
+// another task. A budget of 0 calls all ready callbacks in a single task.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_set_async_completion_budget(napi_env env, uint64_t budget_ns);
+
+// A function run on a thread of the host, passed the data it was submitted with
+typedef void(NAPI_CDECL* node_api_host_task)(void* data);
+
+// A function called for an index of a parallel loop on a thread of the host
+typedef void(NAPI_CDECL* node_api_host_loop_body)(void* data, size_t index);
+
+// Runs a task on the threads executing async work, instead of on a thread of
+// the addon's own. Tasks submitted from another task run before queued tasks
+// of any priority, on the same thread unless an idle thread takes them over.
+// Can be called from any thread.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_submit(node_api_host_priority priority,
+                     node_api_host_task task,
+                     void* data);
+
+// Calls `body` for every index up to `count` on the threads executing async
+// work and the calling thread, returning once all calls returned. Can be
+// called from any thread, including from the `execute` callback of async work
+// and from tasks.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_parallel_for(size_t count,
+                           node_api_host_loop_body body,
+                           void* data);
+
+// Returns the number of threads executing async work and tasks, to split
+// parallel work into as many parts
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_get_thread_count(size_t* result);
+
+// The type of an argument or of the result of a typed function, and the JS
+// value it's converted from or to
+typedef enum {
+  node_api_host_type_void,   // As the result only, to undefined
+  node_api_host_type_bool,   // bool, from and to a boolean
+  node_api_host_type_int32,  // int32_t, from a number (truncated) and to one
+  node_api_host_type_uint32, // uint32_t, from a number (truncated) and to one
+  node_api_host_type_int64,  // int64_t, from a number (truncated) and to one
+                             // (losing precision)
+  node_api_host_type_double, // double, from and to a number
+  node_api_host_type_buffer, // As an argument only, node_api_host_buffer from
+                             // a typed array, DataView or ArrayBuffer
+} node_api_host_type;
+
+// The bytes viewed by a buffer argument, valid until the callback returns
+typedef struct {
+  void* data;
+  size_t byte_length;
+} node_api_host_buffer;
+
+// An argument or the result of a typed function, in the member of its type
+typedef union {
+  bool boolean;
+  int32_t int32;
+  uint32_t uint32;
+  int64_t int64;
+  double number;
+  node_api_host_buffer buffer;
+} node_api_host_value;
+
+// Called with the data the function was created with, an argument per
+// declared type and the result to set unless the result type is void. The
+// callback can't call Node-API and therefore can't throw.
+typedef void(NAPI_CDECL* node_api_host_typed_callback)(
+    void* data, const node_api_host_value* args, node_api_host_value* result);
+
+#define NODE_API_HOST_TYPED_FUNCTION_MAX_ARGS 8
+
+// Creates a function converting its arguments to the declared types before
+// calling `cb`, and the result from the declared type afterwards. Calls skip
+// the napi_get_cb_info and napi_get_value_* calls an addon would make itself,
+// for hot functions with cheap work, such as math helpers. Calls with missing
+// arguments or arguments of other types throw a TypeError, without calling
+// `cb`. Extra arguments are ignored.
+NAPI_EXTERN napi_status NAPI_CDECL
+node_api_host_create_typed_function(napi_env env,
+                                    const char* utf8name,
+                                    size_t length,
+                                    const node_api_host_type* arg_types,
+                                    size_t arg_count,
+                                    node_api_host_type result_type,
+                                    node_api_host_typed_callback cb,
+                                    void* data,
+                                    napi_value* result);
+
+EXTERN_C_END
+
+#endif  // NODE_API_HOST_H_
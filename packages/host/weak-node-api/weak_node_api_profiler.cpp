@@ -0,0 +1,264 @@
+#include "weak_node_api_profiler.hpp"
+
+#if defined(WEAK_NODE_API_PROFILING)
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifndef WEAK_NODE_API_PROFILING_SAMPLE_INTERVAL
+#define WEAK_NODE_API_PROFILING_SAMPLE_INTERVAL 64
+#endif
+
+namespace weak_node_api_profiler {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+struct Counts {
+  uint64_t calls{0};
+  uint64_t sampledCalls{0};
+  uint64_t sampledNanos{0};
+  std::array<uint64_t, WEAK_NODE_API_PROFILE_BUCKETS> histogram{};
+};
+}  // namespace
+
+// Only written by the thread making the calls, which saves it from locking or
+// contending with other threads, while read by any thread getting the profile.
+// The counts only ever grow, and resetting the profile records them as the
+// baseline to report the counts since, instead of writing to them.
+struct Counters {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> sampledCalls{0};
+  std::atomic<uint64_t> sampledNanos{0};
+  std::array<std::atomic<uint64_t>, WEAK_NODE_API_PROFILE_BUCKETS> histogram{};
+  // Guarded by the mutex of the owning thread's counters
+  Counts baseline;
+
+  Counts load() const {
+    Counts result;
+    result.calls = calls.load(std::memory_order_relaxed);
+    result.sampledCalls = sampledCalls.load(std::memory_order_relaxed);
+    result.sampledNanos = sampledNanos.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < WEAK_NODE_API_PROFILE_BUCKETS; i++) {
+      result.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+};
+
+namespace {
+
+void increment(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+// Marks the counters of an env which was torn down, which the owning thread
+// reuses for the next env it makes calls with
+const char forgottenEnvMarker = 0;
+const void* const ForgottenEnv = &forgottenEnvMarker;
+
+// The counters of the calls a thread made with an env, allocated per function
+// on its first call
+struct EnvCounters {
+  // Only changed while holding the mutex of the owning thread's counters
+  std::atomic<const void*> env;
+  std::unique_ptr<std::atomic<Counters*>[]> functions;
+};
+
+struct ThreadCounters {
+  // Locked by the owning thread when adding envs, and by threads reading them
+  std::mutex mutex;
+  std::vector<std::unique_ptr<EnvCounters>> envs;
+  // Only accessed by the owning thread, as calls tend to use the same env
+  EnvCounters* last{nullptr};
+};
+
+// Never freed, keeping the counts of threads which exited, and still usable by
+// threads calling into weak-node-api during static destruction
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadCounters*> threads;
+};
+
+Registry& getRegistry() {
+  static auto* registry = new Registry();
+  return *registry;
+}
+
+thread_local ThreadCounters* currentThread = nullptr;
+
+EnvCounters& getEnvCounters(const void* env) {
+  auto* thread = currentThread;
+  if (!thread) {
+    thread = new ThreadCounters();
+    auto& registry = getRegistry();
+    std::lock_guard lock{registry.mutex};
+    registry.threads.push_back(thread);
+    currentThread = thread;
+  }
+  if (thread->last &&
+      thread->last->env.load(std::memory_order_relaxed) == env) {
+    return *thread->last;
+  }
+  EnvCounters* forgotten = nullptr;
+  for (const auto& envCounters : thread->envs) {
+    const auto* counted = envCounters->env.load(std::memory_order_relaxed);
+    if (counted == env) {
+      thread->last = envCounters.get();
+      return *envCounters;
+    }
+    if (counted == ForgottenEnv) {
+      forgotten = envCounters.get();
+    }
+  }
+  std::lock_guard lock{thread->mutex};
+  if (forgotten) {
+    // Its counts were recorded as the baseline when its env was forgotten
+    forgotten->env.store(env, std::memory_order_relaxed);
+    thread->last = forgotten;
+    return *forgotten;
+  }
+  auto envCounters = std::make_unique<EnvCounters>();
+  envCounters->env = env;
+  envCounters->functions =
+      std::make_unique<std::atomic<Counters*>[]>(functionCount);
+  thread->last = envCounters.get();
+  thread->envs.push_back(std::move(envCounters));
+  return *thread->last;
+}
+
+Counters& getCounters(size_t function, const void* env) {
+  auto& slot = getEnvCounters(env).functions[function];
+  auto* counters = slot.load(std::memory_order_relaxed);
+  if (!counters) {
+    counters = new Counters();
+    slot.store(counters, std::memory_order_release);
+  }
+  return *counters;
+}
+
+int64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+size_t bucketOf(uint64_t nanos) {
+  size_t width = 0;
+  while (nanos > 0 && width < WEAK_NODE_API_PROFILE_BUCKETS - 1) {
+    nanos >>= 1;
+    width++;
+  }
+  return width;
+}
+
+// Visits the counters of every env, or only those of the given env
+template <typename Visit>
+void forEachCounters(Visit visit,
+                     std::optional<const void*> onlyEnv = std::nullopt) {
+  auto& registry = getRegistry();
+  std::lock_guard registryLock{registry.mutex};
+  for (auto* thread : registry.threads) {
+    std::lock_guard threadLock{thread->mutex};
+    for (const auto& envCounters : thread->envs) {
+      const auto* env = envCounters->env.load(std::memory_order_relaxed);
+      if (env == ForgottenEnv || (onlyEnv && env != *onlyEnv)) {
+        continue;
+      }
+      for (size_t function = 0; function < functionCount; function++) {
+        auto* counters =
+            envCounters->functions[function].load(std::memory_order_acquire);
+        if (counters) {
+          visit(function, env, *counters);
+        }
+      }
+      if (onlyEnv) {
+        envCounters->env.store(ForgottenEnv, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+void resetCounters(size_t, const void*, Counters& counters) {
+  counters.baseline = counters.load();
+}
+
+}  // namespace
+
+Call::Call(size_t function, const void* env)
+    : counters_(getCounters(function, env)), start_(0) {
+  const auto calls = counters_.calls.load(std::memory_order_relaxed);
+  counters_.calls.store(calls + 1, std::memory_order_relaxed);
+  if (calls % WEAK_NODE_API_PROFILING_SAMPLE_INTERVAL == 0) {
+    start_ = now();
+  }
+}
+
+Call::~Call() {
+  if (start_ == 0) {
+    return;
+  }
+  const auto nanos = static_cast<uint64_t>(now() - start_);
+  increment(counters_.sampledCalls);
+  increment(counters_.sampledNanos, nanos);
+  increment(counters_.histogram[bucketOf(nanos)]);
+}
+
+}  // namespace weak_node_api_profiler
+
+bool weak_node_api_get_profile(VisitProfileEntry visit, void* context) {
+  using namespace weak_node_api_profiler;
+  // Sums the counts of all threads, ordered to report each function once
+  std::map<std::pair<const void*, size_t>, WeakNodeApiProfileEntry> entries;
+  forEachCounters(
+      [&](size_t function, const void* env, const Counters& counters) {
+        const auto counts = counters.load();
+        const auto& baseline = counters.baseline;
+        auto& entry = entries[{env, function}];
+        entry.function = functionNames[function];
+        entry.env = env;
+        entry.calls += counts.calls - baseline.calls;
+        entry.sampled_calls += counts.sampledCalls - baseline.sampledCalls;
+        entry.sampled_ns += counts.sampledNanos - baseline.sampledNanos;
+        for (size_t i = 0; i < WEAK_NODE_API_PROFILE_BUCKETS; i++) {
+          entry.histogram[i] += counts.histogram[i] - baseline.histogram[i];
+        }
+      });
+  for (const auto& [key, entry] : entries) {
+    // Functions not called since the profile was reset are left out
+    if (entry.calls > 0) {
+      visit(entry, context);
+    }
+  }
+  return true;
+}
+
+void weak_node_api_reset_profile() {
+  using namespace weak_node_api_profiler;
+  forEachCounters(resetCounters);
+}
+
+void weak_node_api_forget_profile_env(const void* env) {
+  using namespace weak_node_api_profiler;
+  forEachCounters(resetCounters, env);
+}
+
+#else
+
+bool weak_node_api_get_profile(VisitProfileEntry, void*) {
+  return false;
+}
+
+void weak_node_api_reset_profile() {}
+
+void weak_node_api_forget_profile_env(const void*) {}
+
+#endif
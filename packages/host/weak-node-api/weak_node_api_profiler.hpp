@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counts of the calls made through the trampolines of weak-node-api, which are
+// only recorded when built with WEAK_NODE_API_PROFILING defined. Every call is
+// counted, while only one in WEAK_NODE_API_PROFILING_SAMPLE_INTERVAL calls of
+// a function on a thread is timed, including the first.
+
+#define WEAK_NODE_API_PROFILE_BUCKETS 32
+
+struct WeakNodeApiProfileEntry {
+  const char* function;
+  // The env passed to the function, null for functions not taking one
+  const void* env;
+  uint64_t calls;
+  uint64_t sampled_calls;
+  // The time spent in the timed calls, including calls back into JS and the
+  // addon made while they ran
+  uint64_t sampled_ns;
+  // The number of timed calls per bit width of their duration in nanoseconds,
+  // the last bucket counting all calls longer than that
+  uint64_t histogram[WEAK_NODE_API_PROFILE_BUCKETS];
+};
+
+typedef void (*VisitProfileEntry)(const WeakNodeApiProfileEntry& entry,
+                                  void* context);
+
+// Calls `visit` for every function called per env, summing the counts of all
+// threads. Returns false if weak-node-api wasn't built for profiling.
+extern "C" bool weak_node_api_get_profile(VisitProfileEntry visit,
+                                          void* context);
+
+// Starts counting over, reporting only the calls counted after the reset
+extern "C" void weak_node_api_reset_profile();
+
+// Drops the counts of an env which was torn down, so they are no longer
+// reported, nor attributed to a new env created at the same address
+extern "C" void weak_node_api_forget_profile_env(const void* env);
+
+namespace weak_node_api_profiler {
+
+// The names of the functions by the index their calls are counted by, as
+// generated along with the trampolines
+extern const char* const functionNames[];
+extern const size_t functionCount;
+
+struct Counters;
+
+// Counts a call of a trampoline for as long as it's in scope
+class Call {
+ public:
+  Call(size_t function, const void* env);
+  ~Call();
+
+  Call(const Call&) = delete;
+  Call& operator=(const Call&) = delete;
+
+ private:
+  Counters& counters_;
+  // Zero unless the call is timed
+  int64_t start_;
+};
+
+}  // namespace weak_node_api_profiler
@@ -0,0 +1,299 @@
+#include <node_api.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../tests/RuntimeNodeApiTestsCommon.h"
+
+// Provided by weak-node-api, missing when linking against the engine directly.
+// Only the address of the injection function is used, to tell if the calls go
+// through the trampolines, while the lookup of the host's functions is only
+// exported by builds with WEAK_NODE_API_BENCHMARKING enabled.
+#ifndef _WIN32
+extern void inject_weak_node_api_host(void) __attribute__((weak));
+extern void* weak_node_api_host_function(const char* name)
+    __attribute__((weak));
+#else
+static void (*inject_weak_node_api_host)(void) = NULL;
+static void* (*weak_node_api_host_function)(const char* name) = NULL;
+#endif
+
+// Handles created by the measured calls are released in batches of this size
+#define HANDLE_SCOPE_BATCH 1000
+#define BUFFER_SIZE 64
+
+typedef struct {
+  napi_status (*get_cb_info)(napi_env env,
+      napi_callback_info info,
+      size_t* argc,
+      napi_value* argv,
+      napi_value* this_arg,
+      void** data);
+  napi_status (*create_int32)(napi_env env, int32_t value, napi_value* result);
+  napi_status (*get_value_string_utf8)(
+      napi_env env, napi_value value, char* buf, size_t bufsize, size_t* result);
+  napi_status (*get_named_property)(
+      napi_env env, napi_value object, const char* utf8name, napi_value* result);
+  napi_status (*create_buffer)(
+      napi_env env, size_t length, void** data, napi_value* result);
+  napi_status (*get_buffer_info)(
+      napi_env env, napi_value value, void** data, size_t* length);
+  napi_status (*is_buffer)(napi_env env, napi_value value, bool* result);
+} api_table;
+
+// The functions the addon is linked against: Trampolines when linked against
+// weak-node-api, otherwise the engine's functions
+static const api_table linked_api = {
+    napi_get_cb_info,
+    napi_create_int32,
+    napi_get_value_string_utf8,
+    napi_get_named_property,
+    napi_create_buffer,
+    napi_get_buffer_info,
+    napi_is_buffer,
+};
+
+// The host functions behind the trampolines, resolved on initialization
+static api_table host_api;
+static bool has_host_api = false;
+static bool has_trampolines = false;
+
+typedef struct {
+  napi_env env;
+  napi_callback_info info;
+  napi_value string;
+  napi_value object;
+  napi_value buffer;
+} inputs;
+
+// Calls the function the given number of times, returning false on failure
+typedef bool (*benchmark_func)(
+    const api_table* api, const inputs* in, uint32_t count);
+
+static bool bench_get_cb_info(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    size_t argc = 1;
+    napi_value argv[1];
+    ok &= api->get_cb_info(in->env, in->info, &argc, argv, NULL, NULL) ==
+          napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_create_int32(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    napi_value result;
+    ok &= api->create_int32(in->env, (int32_t)i, &result) == napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_get_value_string_utf8(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  char buf[32];
+  for (uint32_t i = 0; i < count; i++) {
+    size_t length;
+    ok &= api->get_value_string_utf8(
+              in->env, in->string, buf, sizeof(buf), &length) == napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_get_named_property(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    napi_value result;
+    ok &= api->get_named_property(in->env, in->object, "value", &result) ==
+          napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_create_buffer(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    void* data;
+    napi_value result;
+    ok &= api->create_buffer(in->env, BUFFER_SIZE, &data, &result) == napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_get_buffer_info(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    void* data;
+    size_t length;
+    ok &= api->get_buffer_info(in->env, in->buffer, &data, &length) == napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_is_buffer(
+    const api_table* api, const inputs* in, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    bool result;
+    ok &= api->is_buffer(in->env, in->buffer, &result) == napi_ok;
+  }
+  return ok;
+}
+
+static const struct {
+  const char* name;
+  benchmark_func func;
+} benchmarks[] = {
+    {"napi_get_cb_info", bench_get_cb_info},
+    {"napi_create_int32", bench_create_int32},
+    {"napi_get_value_string_utf8", bench_get_value_string_utf8},
+    {"napi_get_named_property", bench_get_named_property},
+    {"napi_create_buffer", bench_create_buffer},
+    {"napi_get_buffer_info", bench_get_buffer_info},
+    {"napi_is_buffer", bench_is_buffer},
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(*benchmarks))
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Arguments: benchmark name, path ("trampoline" or "direct"), iterations
+// Returns the elapsed time in nanoseconds
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc >= 3, "Not enough arguments, expected 3.");
+
+  char name[64];
+  char path[16];
+  uint32_t iterations;
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(env, argv[0], name, sizeof(name), NULL));
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(env, argv[1], path, sizeof(path), NULL));
+  NODE_API_CALL(env, napi_get_value_uint32(env, argv[2], &iterations));
+
+  benchmark_func func = NULL;
+  for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+    if (strcmp(benchmarks[i].name, name) == 0) {
+      func = benchmarks[i].func;
+    }
+  }
+  NODE_API_ASSERT(env, func != NULL, "Unknown benchmark.");
+
+  // Only a directly linked addon calls the engine without a host table
+  const api_table* api = NULL;
+  if (strcmp(path, "trampoline") == 0) {
+    NODE_API_ASSERT(
+        env, has_trampolines, "The addon isn't linked against weak-node-api.");
+    api = &linked_api;
+  } else if (strcmp(path, "direct") == 0) {
+    NODE_API_ASSERT(env,
+        has_host_api || !has_trampolines,
+        "weak-node-api wasn't built with WEAK_NODE_API_BENCHMARKING.");
+    api = has_host_api ? &host_api : &linked_api;
+  }
+  NODE_API_ASSERT(env, api != NULL, "Unknown path.");
+
+  inputs in = {env, info, NULL, NULL, NULL};
+  void* buffer_data;
+  NODE_API_CALL(env,
+      napi_create_string_utf8(env, "hello world", NAPI_AUTO_LENGTH, &in.string));
+  NODE_API_CALL(env, napi_create_object(env, &in.object));
+  NODE_API_CALL(env,
+      napi_set_named_property(env, in.object, "value", in.string));
+  NODE_API_CALL(
+      env, napi_create_buffer(env, BUFFER_SIZE, &buffer_data, &in.buffer));
+
+  bool ok = true;
+  uint64_t elapsed = 0;
+  for (uint32_t done = 0; done < iterations; done += HANDLE_SCOPE_BATCH) {
+    const uint32_t count = iterations - done < HANDLE_SCOPE_BATCH
+                               ? iterations - done
+                               : HANDLE_SCOPE_BATCH;
+    napi_handle_scope scope;
+    NODE_API_CALL(env, napi_open_handle_scope(env, &scope));
+    const uint64_t start = now_ns();
+    ok &= func(api, &in, count);
+    elapsed += now_ns() - start;
+    NODE_API_CALL(env, napi_close_handle_scope(env, scope));
+  }
+  NODE_API_ASSERT(env, ok, "Expected every call to succeed.");
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_double(env, (double)elapsed, &result));
+  return result;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  has_trampolines = inject_weak_node_api_host != NULL;
+  if (weak_node_api_host_function != NULL) {
+    host_api.get_cb_info = weak_node_api_host_function("napi_get_cb_info");
+    host_api.create_int32 = weak_node_api_host_function("napi_create_int32");
+    host_api.get_value_string_utf8 =
+        weak_node_api_host_function("napi_get_value_string_utf8");
+    host_api.get_named_property =
+        weak_node_api_host_function("napi_get_named_property");
+    host_api.create_buffer = weak_node_api_host_function("napi_create_buffer");
+    host_api.get_buffer_info =
+        weak_node_api_host_function("napi_get_buffer_info");
+    host_api.is_buffer = weak_node_api_host_function("napi_is_buffer");
+    // Functions are only missing if the host didn't inject them
+    has_host_api = host_api.get_cb_info && host_api.create_int32 &&
+                   host_api.get_value_string_utf8 &&
+                   host_api.get_named_property && host_api.create_buffer &&
+                   host_api.get_buffer_info && host_api.is_buffer;
+  }
+
+  napi_value names;
+  NODE_API_CALL(env, napi_create_array_with_length(env, BENCHMARK_COUNT, &names));
+  for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+    napi_value name;
+    NODE_API_CALL(env,
+        napi_create_string_utf8(
+            env, benchmarks[i].name, NAPI_AUTO_LENGTH, &name));
+    NODE_API_CALL(env, napi_set_element(env, names, (uint32_t)i, name));
+  }
+
+  napi_value paths;
+  NODE_API_CALL(env, napi_create_array(env, &paths));
+  uint32_t path_count = 0;
+  const char* path_names[] = {"trampoline", "direct"};
+  const bool has_path[] = {has_trampolines, has_host_api || !has_trampolines};
+  for (size_t i = 0; i < 2; i++) {
+    if (!has_path[i]) {
+      continue;
+    }
+    napi_value path;
+    NODE_API_CALL(env,
+        napi_create_string_utf8(env, path_names[i], NAPI_AUTO_LENGTH, &path));
+    NODE_API_CALL(env, napi_set_element(env, paths, path_count++, path));
+  }
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY_VALUE("benchmarks", names),
+      DECLARE_NODE_API_PROPERTY_VALUE("paths", paths),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,35 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const addon = require("bindings")("addon.node");
+
+const ITERATIONS = 100000;
+const ROUNDS = 5;
+
+// Prints a JSON line per result, taking the fastest of a few rounds
+module.exports = () => {
+  const results = [];
+  for (const name of addon.benchmarks) {
+    for (const path of addon.paths) {
+      // Warm up
+      addon.run(name, path, ITERATIONS / 10);
+      let fastest = Infinity;
+      for (let round = 0; round < ROUNDS; round++) {
+        fastest = Math.min(fastest, addon.run(name, path, ITERATIONS));
+      }
+      const result = {
+        benchmark: "call_overhead",
+        function: name,
+        path,
+        iterations: ITERATIONS,
+        nsPerCall: fastest / ITERATIONS,
+      };
+      console.log(JSON.stringify(result));
+      results.push(result);
+    }
+  }
+  return results;
+};
+
+if (typeof require.main !== "undefined" && require.main === module) {
+  module.exports();
+}
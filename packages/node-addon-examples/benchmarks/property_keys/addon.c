@@ -0,0 +1,139 @@
+#include <node_api.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../tests/RuntimeNodeApiTestsCommon.h"
+
+// Handles created by the measured calls are released in batches of this size
+#define HANDLE_SCOPE_BATCH 1000
+
+// The properties read in turns, as an addon reading the fields of a record
+static const char* const keys[] = {"width", "height", "x", "y"};
+#define KEY_COUNT (sizeof(keys) / sizeof(*keys))
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Creates a new string for every read, as addons not using property keys do
+static bool bench_create_string_utf8(
+    napi_env env, napi_value object, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    napi_value key, value;
+    ok &= napi_create_string_utf8(
+              env, keys[i % KEY_COUNT], NAPI_AUTO_LENGTH, &key) == napi_ok &&
+          napi_get_property(env, object, key, &value) == napi_ok;
+  }
+  return ok;
+}
+
+// Gets the interned key for every read
+static bool bench_create_property_key_utf8(
+    napi_env env, napi_value object, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    napi_value key, value;
+    ok &= node_api_create_property_key_utf8(
+              env, keys[i % KEY_COUNT], NAPI_AUTO_LENGTH, &key) == napi_ok &&
+          napi_get_property(env, object, key, &value) == napi_ok;
+  }
+  return ok;
+}
+
+// Leaves creating the key to the engine
+static bool bench_get_named_property(
+    napi_env env, napi_value object, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    napi_value value;
+    ok &= napi_get_named_property(env, object, keys[i % KEY_COUNT], &value) ==
+          napi_ok;
+  }
+  return ok;
+}
+
+typedef bool (*benchmark_func)(napi_env env, napi_value object, uint32_t count);
+
+static const struct {
+  const char* name;
+  benchmark_func func;
+} benchmarks[] = {
+    {"napi_create_string_utf8", bench_create_string_utf8},
+    {"node_api_create_property_key_utf8", bench_create_property_key_utf8},
+    {"napi_get_named_property", bench_get_named_property},
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(*benchmarks))
+
+// Arguments: benchmark name, an object with the properties, iterations.
+// Returns the elapsed time in nanoseconds of reading the properties in a
+// native loop.
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc >= 3, "Not enough arguments, expected 3.");
+
+  char name[64];
+  uint32_t iterations;
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(env, argv[0], name, sizeof(name), NULL));
+  NODE_API_CALL(env, napi_get_value_uint32(env, argv[2], &iterations));
+
+  benchmark_func func = NULL;
+  for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+    if (strcmp(benchmarks[i].name, name) == 0) {
+      func = benchmarks[i].func;
+    }
+  }
+  NODE_API_ASSERT(env, func != NULL, "Unknown benchmark.");
+
+  bool ok = true;
+  uint64_t elapsed = 0;
+  for (uint32_t done = 0; done < iterations; done += HANDLE_SCOPE_BATCH) {
+    const uint32_t count = iterations - done < HANDLE_SCOPE_BATCH
+                               ? iterations - done
+                               : HANDLE_SCOPE_BATCH;
+    napi_handle_scope scope;
+    NODE_API_CALL(env, napi_open_handle_scope(env, &scope));
+    const uint64_t start = now_ns();
+    ok &= func(env, argv[1], count);
+    elapsed += now_ns() - start;
+    NODE_API_CALL(env, napi_close_handle_scope(env, scope));
+  }
+  NODE_API_ASSERT(env, ok, "Expected every call to succeed.");
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_double(env, (double)elapsed, &result));
+  return result;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value names;
+  NODE_API_CALL(env, napi_create_array_with_length(env, BENCHMARK_COUNT, &names));
+  for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+    napi_value name;
+    NODE_API_CALL(env,
+        napi_create_string_utf8(
+            env, benchmarks[i].name, NAPI_AUTO_LENGTH, &name));
+    NODE_API_CALL(env, napi_set_element(env, names, (uint32_t)i, name));
+  }
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY_VALUE("benchmarks", names),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
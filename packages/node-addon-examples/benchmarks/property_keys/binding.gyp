@@ -0,0 +1,9 @@
+{
+  "targets": [
+    {
+      "target_name": "addon",
+      "sources": [ "addon.c" ],
+      "defines": [ "NAPI_VERSION=10" ]
+    }
+  ]
+}
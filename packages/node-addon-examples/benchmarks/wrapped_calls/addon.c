@@ -0,0 +1,324 @@
+#include <node_api.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../tests/RuntimeNodeApiTestsCommon.h"
+
+// Provided by weak-node-api, missing when linking against the engine directly.
+// Only the address of the injection function is used, to tell if the calls go
+// through the trampolines, while the lookup of the host's functions is only
+// exported by builds with WEAK_NODE_API_BENCHMARKING enabled.
+#ifndef _WIN32
+extern void inject_weak_node_api_host(void) __attribute__((weak));
+extern void* weak_node_api_host_function(const char* name)
+    __attribute__((weak));
+#else
+static void (*inject_weak_node_api_host)(void) = NULL;
+static void* (*weak_node_api_host_function)(const char* name) = NULL;
+#endif
+
+// Handles created by the measured calls are released in batches of this size
+#define HANDLE_SCOPE_BATCH 1000
+
+typedef struct {
+  napi_status (*get_cb_info)(napi_env env,
+      napi_callback_info info,
+      size_t* argc,
+      napi_value* argv,
+      napi_value* this_arg,
+      void** data);
+  napi_status (*unwrap)(napi_env env, napi_value js_object, void** result);
+  napi_status (*check_object_type_tag)(napi_env env,
+      napi_value value,
+      const napi_type_tag* type_tag,
+      bool* result);
+} api_table;
+
+// The functions the addon is linked against: Trampolines when linked against
+// weak-node-api, otherwise the engine's functions
+static const api_table linked_api = {
+    napi_get_cb_info,
+    napi_unwrap,
+    napi_check_object_type_tag,
+};
+
+// The host functions behind the trampolines, resolved on initialization
+static api_table host_api;
+static bool has_host_api = false;
+static bool has_trampolines = false;
+
+static const napi_type_tag counter_type_tag = {
+    0x9c2ba1e1f0d84a6bULL, 0x8d3e5c7f21a46b90ULL};
+
+typedef struct {
+  uint32_t count;
+} counter;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void FinalizeCounter(napi_env env, void* data, void* hint) {
+  free(data);
+}
+
+static napi_value New(napi_env env, napi_callback_info info) {
+  napi_value this_arg;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, NULL, NULL, &this_arg, NULL));
+  counter* c = (counter*)calloc(1, sizeof(counter));
+  NODE_API_ASSERT(env, c != NULL, "Failed to allocate the counter.");
+  NODE_API_CALL(env,
+      napi_wrap(env, this_arg, c, FinalizeCounter, NULL, NULL));
+  NODE_API_CALL(env,
+      napi_type_tag_object(env, this_arg, &counter_type_tag));
+  return this_arg;
+}
+
+// A method as class-based addons implement them: Unwrapping the receiver on
+// every call, through the functions of the table passed as data
+static napi_value Increment(napi_env env, napi_callback_info info) {
+  napi_value this_arg;
+  void* data;
+  counter* c;
+  const api_table* api;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, NULL, NULL, NULL, &data));
+  api = (const api_table*)data;
+  NODE_API_CALL(env, api->get_cb_info(env, info, NULL, NULL, &this_arg, NULL));
+  NODE_API_CALL(env, api->unwrap(env, this_arg, (void**)&c));
+  c->count++;
+  return NULL;
+}
+
+// Like Increment, checking the type tag before unwrapping
+static napi_value IncrementChecked(napi_env env, napi_callback_info info) {
+  napi_value this_arg;
+  void* data;
+  bool is_counter;
+  counter* c;
+  const api_table* api;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, NULL, NULL, NULL, &data));
+  api = (const api_table*)data;
+  NODE_API_CALL(env, api->get_cb_info(env, info, NULL, NULL, &this_arg, NULL));
+  NODE_API_CALL(env,
+      api->check_object_type_tag(env, this_arg, &counter_type_tag, &is_counter));
+  NODE_API_ASSERT(env, is_counter, "Expected a counter.");
+  NODE_API_CALL(env, api->unwrap(env, this_arg, (void**)&c));
+  c->count++;
+  return NULL;
+}
+
+static bool bench_unwrap(
+    const api_table* api, napi_env env, napi_value object, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    void* result;
+    ok &= api->unwrap(env, object, &result) == napi_ok;
+  }
+  return ok;
+}
+
+static bool bench_check_object_type_tag(
+    const api_table* api, napi_env env, napi_value object, uint32_t count) {
+  bool ok = true;
+  for (uint32_t i = 0; i < count; i++) {
+    bool result;
+    ok &= api->check_object_type_tag(
+              env, object, &counter_type_tag, &result) == napi_ok &&
+          result;
+  }
+  return ok;
+}
+
+typedef bool (*benchmark_func)(
+    const api_table* api, napi_env env, napi_value object, uint32_t count);
+
+static const struct {
+  const char* name;
+  benchmark_func func;
+} benchmarks[] = {
+    {"napi_unwrap", bench_unwrap},
+    {"napi_check_object_type_tag", bench_check_object_type_tag},
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(*benchmarks))
+
+static const api_table* GetApi(napi_env env, napi_value value) {
+  char path[16];
+  if (napi_get_value_string_utf8(env, value, path, sizeof(path), NULL) !=
+      napi_ok) {
+    return NULL;
+  }
+  // Only a directly linked addon calls the engine without a host table
+  if (strcmp(path, "trampoline") == 0) {
+    return has_trampolines ? &linked_api : NULL;
+  } else if (strcmp(path, "direct") == 0) {
+    return has_host_api ? &host_api : has_trampolines ? NULL : &linked_api;
+  }
+  return NULL;
+}
+
+// Arguments: benchmark name, path ("trampoline" or "direct"), a counter,
+// iterations. Returns the elapsed time in nanoseconds of calling the function
+// in a native loop.
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc >= 4, "Not enough arguments, expected 4.");
+
+  char name[64];
+  uint32_t iterations;
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(env, argv[0], name, sizeof(name), NULL));
+  NODE_API_CALL(env, napi_get_value_uint32(env, argv[3], &iterations));
+
+  benchmark_func func = NULL;
+  for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+    if (strcmp(benchmarks[i].name, name) == 0) {
+      func = benchmarks[i].func;
+    }
+  }
+  NODE_API_ASSERT(env, func != NULL, "Unknown benchmark.");
+  const api_table* api = GetApi(env, argv[1]);
+  NODE_API_ASSERT(env, api != NULL, "Unknown path.");
+
+  bool ok = true;
+  uint64_t elapsed = 0;
+  for (uint32_t done = 0; done < iterations; done += HANDLE_SCOPE_BATCH) {
+    const uint32_t count = iterations - done < HANDLE_SCOPE_BATCH
+                               ? iterations - done
+                               : HANDLE_SCOPE_BATCH;
+    napi_handle_scope scope;
+    NODE_API_CALL(env, napi_open_handle_scope(env, &scope));
+    const uint64_t start = now_ns();
+    ok &= func(api, env, argv[2], count);
+    elapsed += now_ns() - start;
+    NODE_API_CALL(env, napi_close_handle_scope(env, scope));
+  }
+  NODE_API_ASSERT(env, ok, "Expected every call to succeed.");
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_double(env, (double)elapsed, &result));
+  return result;
+}
+
+// Arguments: the name of a method, path, a counter, iterations. Returns the
+// elapsed time in nanoseconds of calling the method from a JS loop.
+static napi_value RunMethod(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc >= 4, "Not enough arguments, expected 4.");
+
+  char name[64];
+  char path[16];
+  uint32_t iterations;
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(env, argv[0], name, sizeof(name), NULL));
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(env, argv[1], path, sizeof(path), NULL));
+  NODE_API_CALL(env, napi_get_value_uint32(env, argv[3], &iterations));
+  NODE_API_ASSERT(env, GetApi(env, argv[1]) != NULL, "Unknown path.");
+
+  // The methods are named after the path, such as "incrementDirect"
+  char method_name[96];
+  snprintf(method_name, sizeof(method_name), "%s%c%s", name,
+      path[0] - 'a' + 'A', path + 1);
+  napi_value method;
+  NODE_API_CALL(env,
+      napi_get_named_property(env, argv[2], method_name, &method));
+
+  bool ok = true;
+  uint64_t elapsed = 0;
+  for (uint32_t done = 0; done < iterations; done += HANDLE_SCOPE_BATCH) {
+    const uint32_t count = iterations - done < HANDLE_SCOPE_BATCH
+                               ? iterations - done
+                               : HANDLE_SCOPE_BATCH;
+    napi_handle_scope scope;
+    NODE_API_CALL(env, napi_open_handle_scope(env, &scope));
+    const uint64_t start = now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+      ok &= napi_call_function(env, argv[2], method, 0, NULL, NULL) == napi_ok;
+    }
+    elapsed += now_ns() - start;
+    NODE_API_CALL(env, napi_close_handle_scope(env, scope));
+  }
+  NODE_API_ASSERT(env, ok, "Expected every call to succeed.");
+
+  napi_value result;
+  NODE_API_CALL(env, napi_create_double(env, (double)elapsed, &result));
+  return result;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  has_trampolines = inject_weak_node_api_host != NULL;
+  if (weak_node_api_host_function != NULL) {
+    host_api.get_cb_info = weak_node_api_host_function("napi_get_cb_info");
+    host_api.unwrap = weak_node_api_host_function("napi_unwrap");
+    host_api.check_object_type_tag =
+        weak_node_api_host_function("napi_check_object_type_tag");
+    // Functions are only missing if the host didn't inject them
+    has_host_api = host_api.get_cb_info && host_api.unwrap &&
+                   host_api.check_object_type_tag;
+  }
+
+  napi_property_descriptor methods[] = {
+      {"incrementTrampoline", NULL, Increment, NULL, NULL, NULL, napi_default,
+          (void*)&linked_api},
+      {"incrementCheckedTrampoline", NULL, IncrementChecked, NULL, NULL, NULL,
+          napi_default, (void*)&linked_api},
+      {"incrementDirect", NULL, Increment, NULL, NULL, NULL, napi_default,
+          has_host_api ? (void*)&host_api : (void*)&linked_api},
+      {"incrementCheckedDirect", NULL, IncrementChecked, NULL, NULL, NULL,
+          napi_default, has_host_api ? (void*)&host_api : (void*)&linked_api},
+  };
+  napi_value counter_class;
+  NODE_API_CALL(env,
+      napi_define_class(env, "Counter", NAPI_AUTO_LENGTH, New, NULL,
+          sizeof(methods) / sizeof(*methods), methods, &counter_class));
+
+  napi_value names;
+  NODE_API_CALL(env, napi_create_array_with_length(env, BENCHMARK_COUNT, &names));
+  for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+    napi_value name;
+    NODE_API_CALL(env,
+        napi_create_string_utf8(
+            env, benchmarks[i].name, NAPI_AUTO_LENGTH, &name));
+    NODE_API_CALL(env, napi_set_element(env, names, (uint32_t)i, name));
+  }
+
+  napi_value paths;
+  NODE_API_CALL(env, napi_create_array(env, &paths));
+  uint32_t path_count = 0;
+  const char* path_names[] = {"trampoline", "direct"};
+  const bool has_path[] = {has_trampolines, has_host_api || !has_trampolines};
+  for (size_t i = 0; i < 2; i++) {
+    if (!has_path[i]) {
+      continue;
+    }
+    napi_value path;
+    NODE_API_CALL(env,
+        napi_create_string_utf8(env, path_names[i], NAPI_AUTO_LENGTH, &path));
+    NODE_API_CALL(env, napi_set_element(env, paths, path_count++, path));
+  }
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY("runMethod", RunMethod),
+      DECLARE_NODE_API_PROPERTY_VALUE("Counter", counter_class),
+      DECLARE_NODE_API_PROPERTY_VALUE("benchmarks", names),
+      DECLARE_NODE_API_PROPERTY_VALUE("paths", paths),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,57 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const addon = require("bindings")("addon.node");
+
+const ITERATIONS = 100000;
+const ROUNDS = 5;
+const METHODS = ["increment", "incrementChecked"];
+
+// Takes the fastest of a few rounds, after warming up
+function measure(run) {
+  run(ITERATIONS / 10);
+  let fastest = Infinity;
+  for (let round = 0; round < ROUNDS; round++) {
+    fastest = Math.min(fastest, run(ITERATIONS));
+  }
+  return fastest / ITERATIONS;
+}
+
+// Prints a JSON line per result: Calls of the unwrapping functions from a
+// native loop, and calls of methods unwrapping their receiver from JS
+module.exports = () => {
+  const counter = new addon.Counter();
+  const results = [];
+  const report = (result) => {
+    console.log(JSON.stringify(result));
+    results.push(result);
+  };
+  for (const path of addon.paths) {
+    for (const name of addon.benchmarks) {
+      report({
+        benchmark: "wrapped_calls",
+        function: name,
+        path,
+        iterations: ITERATIONS,
+        nsPerCall: measure((iterations) =>
+          addon.run(name, path, counter, iterations),
+        ),
+      });
+    }
+    for (const method of METHODS) {
+      report({
+        benchmark: "wrapped_calls",
+        method,
+        path,
+        iterations: ITERATIONS,
+        nsPerCall: measure((iterations) =>
+          addon.runMethod(method, path, counter, iterations),
+        ),
+      });
+    }
+  }
+  return results;
+};
+
+if (typeof require.main !== "undefined" && require.main === module) {
+  module.exports();
+}
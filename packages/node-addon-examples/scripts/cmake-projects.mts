@@ -3,7 +3,11 @@ import path from "node:path";
 
 export const EXAMPLES_DIR = path.resolve(import.meta.dirname, "../examples");
 export const TESTS_DIR = path.resolve(import.meta.dirname, "../tests");
-export const DIRS = [EXAMPLES_DIR, TESTS_DIR];
+export const BENCHMARKS_DIR = path.resolve(
+  import.meta.dirname,
+  "../benchmarks",
+);
+export const DIRS = [EXAMPLES_DIR, TESTS_DIR, BENCHMARKS_DIR];
 
 export function findCMakeProjectsRecursively(dir: string): string[] {
   let results: string[] = [];
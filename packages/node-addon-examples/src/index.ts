@@ -97,11 +97,27 @@ export const suites: Record<
       ),
   },
   "5-async-work": {
-    // TODO: This crashes (SIGABRT)
-    // "async_work_thread_safe_function": () => require("../examples/5-async-work/async_work_thread_safe_function/napi/index.js"),
+    async_work_thread_safe_function: () =>
+      require("../examples/5-async-work/async_work_thread_safe_function/napi/index.js"),
   },
   tests: {
     buffers: () => require("../tests/buffers/addon.js"),
     async: () => require("../tests/async/addon.js"),
+    async_priorities: () => require("../tests/async_priorities/addon.js"),
+    async_completions: () => require("../tests/async_completions/addon.js"),
+    parallel_tasks: () => require("../tests/parallel_tasks/addon.js"),
+    concurrency: () => require("../tests/concurrency/addon.js"),
+    threadsafe_function: () => require("../tests/threadsafe_function/addon.js"),
+    object_arrays: () => require("../tests/object_arrays/addon.js"),
+    typed_functions: () => require("../tests/typed_functions/addon.js"),
+    streams: () => require("../tests/streams/addon.js"),
+    symbols_and_errors: () => require("../tests/symbols_and_errors/addon.js"),
   },
 };
+
+// Benchmarks print a JSON line per result and return the results
+export const benchmarks: Record<string, () => unknown> = {
+  call_overhead: () => require("../benchmarks/call_overhead/addon.js")(),
+  wrapped_calls: () => require("../benchmarks/wrapped_calls/addon.js")(),
+  property_keys: () => require("../benchmarks/property_keys/addon.js")(),
+};
@@ -0,0 +1,84 @@
+#include <node_api.h>
+#include <node_api_host.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+#define JOB_COUNT 256
+
+typedef struct {
+  napi_async_work _request;
+  int _index;
+} job;
+
+static job jobs[JOB_COUNT];
+static int pending_count = 0;
+static napi_ref on_complete_ref;
+
+static void Execute(napi_env env, void* data) {}
+
+static void Complete(napi_env env, napi_status status, void* data) {
+  job* j = (job*)data;
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, j->_request));
+
+  napi_value on_complete, global, index;
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_get_reference_value(env, on_complete_ref, &on_complete));
+  if (--pending_count == 0) {
+    NODE_API_CALL_RETURN_VOID(env,
+                              napi_delete_reference(env, on_complete_ref));
+  }
+  NODE_API_CALL_RETURN_VOID(env, napi_get_global(env, &global));
+  NODE_API_CALL_RETURN_VOID(env, napi_create_int32(env, j->_index, &index));
+  // Might throw, which must not keep the other jobs from completing
+  napi_call_function(env, global, on_complete, 1, &index, NULL);
+}
+
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 2, "Expected a budget and a callback");
+  NODE_API_ASSERT(env, pending_count == 0, "Expected the last run to be done");
+
+  int64_t budget_ns;
+  NODE_API_CALL(env, napi_get_value_int64(env, argv[0], &budget_ns));
+  NODE_API_CALL(env,
+                node_api_host_set_async_completion_budget(
+                    env, (uint64_t)budget_ns));
+  NODE_API_CALL(env, napi_create_reference(env, argv[1], 1, &on_complete_ref));
+
+  napi_value name;
+  NODE_API_CALL(env,
+                napi_create_string_utf8(
+                    env, "TestResource", NAPI_AUTO_LENGTH, &name));
+  for (int i = 0; i < JOB_COUNT; i++) {
+    job* j = &jobs[i];
+    j->_index = i;
+    NODE_API_CALL(env,
+                  napi_create_async_work(
+                      env, NULL, name, Execute, Complete, j, &j->_request));
+    pending_count++;
+    NODE_API_CALL(env, napi_queue_async_work(env, j->_request));
+  }
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value jobCount;
+  NODE_API_CALL(env, napi_create_int32(env, JOB_COUNT, &jobCount));
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY_VALUE("jobCount", jobCount),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(properties[0]), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,43 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+// Resolves with the number of JS tasks the completions were called in, which
+// are told apart by the microtasks run after each task
+function run(budgetNs, onComplete = () => {}) {
+  return new Promise((resolve) => {
+    let completed = 0;
+    let tasks = 0;
+    let inTask = false;
+    addon.run(budgetNs, (index) => {
+      if (!inTask) {
+        inTask = true;
+        tasks++;
+        queueMicrotask(() => (inTask = false));
+      }
+      if (++completed === addon.jobCount) {
+        resolve(tasks);
+      }
+      onComplete(index);
+    });
+  });
+}
+
+module.exports = async () => {
+  // Jobs finishing while the JS thread is busy queueing are completed together
+  const unlimitedTasks = await run(0);
+  assert(unlimitedTasks < addon.jobCount);
+
+  // Out of budget after every completion, yielding the JS thread each time
+  const exhaustedTasks = await run(1);
+  assert.strictEqual(exhaustedTasks, addon.jobCount);
+
+  // An exception thrown by a completion doesn't fail the others
+  const thrownTasks = await run(0, (index) => {
+    if (index % 2 === 0) {
+      throw new Error("Thrown from a completion");
+    }
+  });
+  assert(thrownTasks > 0);
+};
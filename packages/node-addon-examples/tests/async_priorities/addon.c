@@ -0,0 +1,203 @@
+#include <node_api.h>
+#include <node_api_host.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif _POSIX_C_SOURCE >= 199309L
+#include <time.h>  // for nanosleep
+#else
+#include <unistd.h>  // for usleep
+#endif
+
+void sleep_ms(int milliseconds) {  // cross-platform sleep function
+#ifdef WIN32
+  Sleep(milliseconds);
+#elif _POSIX_C_SOURCE >= 199309L
+  struct timespec ts;
+  ts.tv_sec = milliseconds / 1000;
+  ts.tv_nsec = (milliseconds % 1000) * 1000000;
+  nanosleep(&ts, NULL);
+#else
+  if (milliseconds >= 1000) sleep(milliseconds / 1000);
+  usleep((milliseconds % 1000) * 1000);
+#endif
+}
+
+// Far more background jobs than threads to execute them, so most of them are
+// still queued when the urgent job is queued
+#define BACKGROUND_JOB_COUNT 512
+
+typedef struct {
+  napi_async_work _request;
+  bool _executed;
+  bool _cancelled;
+  napi_status _status;
+  // The number of jobs which had started when this one started
+  int _started_before;
+} job;
+
+static job background_jobs[BACKGROUND_JOB_COUNT];
+static job urgent_job;
+static int started_count = 0;
+static int pending_count = 0;
+static napi_ref callback_ref;
+static node_api_host_async_work_stats queued_stats;
+
+static void Execute(napi_env env, void* data) {
+  job* j = (job*)data;
+  j->_started_before = __atomic_fetch_add(&started_count, 1, __ATOMIC_SEQ_CST);
+  j->_executed = true;
+  sleep_ms(2);
+}
+
+static napi_value CreateResult(napi_env env) {
+  int cancelled = 0;
+  int cancelled_but_executed = 0;
+  int cancelled_with_wrong_status = 0;
+  for (int i = 0; i < BACKGROUND_JOB_COUNT; i++) {
+    const job* j = &background_jobs[i];
+    if (j->_cancelled) {
+      cancelled++;
+      cancelled_but_executed += j->_executed;
+      cancelled_with_wrong_status += j->_status != napi_cancelled;
+    }
+  }
+
+  node_api_host_async_work_stats stats;
+  NODE_API_CALL(env, node_api_host_get_async_work_stats(env, &stats));
+
+  napi_value result, value;
+  NODE_API_CALL(env, napi_create_object(env, &result));
+  NODE_API_CALL(env,
+                napi_create_int32(env, urgent_job._started_before, &value));
+  NODE_API_CALL(
+      env, napi_set_named_property(env, result, "urgentStartedAfter", value));
+  NODE_API_CALL(env, napi_create_int32(env, cancelled, &value));
+  NODE_API_CALL(env, napi_set_named_property(env, result, "cancelled", value));
+  NODE_API_CALL(env, napi_create_int32(env, cancelled_but_executed, &value));
+  NODE_API_CALL(
+      env,
+      napi_set_named_property(env, result, "cancelledButExecuted", value));
+  NODE_API_CALL(env,
+                napi_create_int32(env, cancelled_with_wrong_status, &value));
+  NODE_API_CALL(
+      env,
+      napi_set_named_property(env, result, "cancelledWithWrongStatus", value));
+  NODE_API_CALL(env,
+                napi_create_double(
+                    env, (double)queued_stats.queued_background, &value));
+  NODE_API_CALL(
+      env, napi_set_named_property(env, result, "queuedBackground", value));
+  NODE_API_CALL(env, napi_create_double(env, (double)stats.cancelled, &value));
+  NODE_API_CALL(
+      env, napi_set_named_property(env, result, "statsCancelled", value));
+  NODE_API_CALL(env, napi_create_double(env, (double)stats.started, &value));
+  NODE_API_CALL(
+      env, napi_set_named_property(env, result, "statsStarted", value));
+  NODE_API_CALL(env,
+                napi_create_double(env, (double)stats.max_wait_ns, &value));
+  NODE_API_CALL(
+      env, napi_set_named_property(env, result, "statsMaxWaitNs", value));
+  return result;
+}
+
+static void Complete(napi_env env, napi_status status, void* data) {
+  job* j = (job*)data;
+  j->_status = status;
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, j->_request));
+  if (--pending_count > 0) {
+    return;
+  }
+
+  napi_value callback, global, result;
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_get_reference_value(env, callback_ref, &callback));
+  NODE_API_CALL_RETURN_VOID(env, napi_get_global(env, &global));
+  result = CreateResult(env);
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_call_function(env, global, callback, 1, &result, NULL));
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_reference(env, callback_ref));
+}
+
+static napi_status QueueJob(napi_env env, job* j, napi_value name) {
+  napi_status status = napi_create_async_work(
+      env, NULL, name, Execute, Complete, j, &j->_request);
+  if (status != napi_ok) {
+    return status;
+  }
+  pending_count++;
+  return napi_queue_async_work(env, j->_request);
+}
+
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 1, "Expected a callback");
+  NODE_API_CALL(env, napi_create_reference(env, argv[0], 1, &callback_ref));
+
+  napi_value name;
+  NODE_API_CALL(env,
+                napi_create_string_utf8(
+                    env, "TestResource", NAPI_AUTO_LENGTH, &name));
+
+  // The background jobs get their priority from the env
+  NODE_API_CALL(env,
+                node_api_host_set_default_async_work_priority(
+                    env, node_api_host_priority_background));
+  for (int i = 0; i < BACKGROUND_JOB_COUNT; i++) {
+    NODE_API_CALL(env, QueueJob(env, &background_jobs[i], name));
+  }
+  NODE_API_CALL(env,
+                node_api_host_set_default_async_work_priority(
+                    env, node_api_host_priority_default));
+
+  // The urgent job gets its priority before being queued
+  NODE_API_CALL(env,
+                napi_create_async_work(env, NULL, name, Execute, Complete,
+                                       &urgent_job, &urgent_job._request));
+  NODE_API_CALL(env,
+                node_api_host_set_async_work_priority(
+                    env, urgent_job._request,
+                    node_api_host_priority_user_blocking));
+  pending_count++;
+  NODE_API_CALL(env, napi_queue_async_work(env, urgent_job._request));
+
+  NODE_API_CALL(env, node_api_host_get_async_work_stats(env, &queued_stats));
+
+  // Cancels every other background job, which fails for those already started.
+  // Changing their priority first only takes effect when queued next, so they
+  // are still dropped from the background queue.
+  for (int i = 1; i < BACKGROUND_JOB_COUNT; i += 2) {
+    job* j = &background_jobs[i];
+    NODE_API_CALL(env,
+                  node_api_host_set_async_work_priority(
+                      env, j->_request, node_api_host_priority_user_blocking));
+    j->_cancelled = napi_cancel_async_work(env, j->_request) == napi_ok;
+  }
+
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value backgroundJobCount;
+  NODE_API_CALL(
+      env, napi_create_int32(env, BACKGROUND_JOB_COUNT, &backgroundJobCount));
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY_VALUE("backgroundJobCount", backgroundJobCount),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(properties[0]), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,24 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+module.exports = async () => {
+  const result = await new Promise((resolve) => addon.run(resolve));
+
+  // Most background jobs were still queued when the urgent job was queued,
+  // which only waited for those already started
+  assert(result.queuedBackground > addon.backgroundJobCount / 2);
+  assert(result.urgentStartedAfter < addon.backgroundJobCount / 2);
+
+  // Cancelled jobs are completed without being executed
+  assert(result.cancelled > 0);
+  assert.strictEqual(result.cancelledButExecuted, 0);
+  assert.strictEqual(result.cancelledWithWrongStatus, 0);
+
+  assert(result.statsCancelled >= result.cancelled);
+  assert(
+    result.statsStarted >= addon.backgroundJobCount + 1 - result.cancelled,
+  );
+  assert(result.statsMaxWaitNs > 0);
+};
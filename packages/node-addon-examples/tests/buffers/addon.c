@@ -50,6 +50,19 @@ static napi_value newBuffer(napi_env env, napi_callback_info info) {
   return theBuffer;
 }
 
+static napi_value newBufferOfLength(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 1, "Wrong number of arguments");
+  uint32_t length;
+  NODE_API_CALL(env, napi_get_value_uint32(env, args[0], &length));
+
+  napi_value theBuffer;
+  NODE_API_CALL(env, napi_create_buffer(env, length, NULL, &theBuffer));
+  return theBuffer;
+}
+
 static napi_value newExternalBuffer(napi_env env, napi_callback_info info) {
   napi_value theBuffer;
   char* theCopy = strdup(theText);
@@ -74,8 +87,13 @@ static napi_value getDeleterCallCount(napi_env env, napi_callback_info info) {
 
 static napi_value copyBuffer(napi_env env, napi_callback_info info) {
   napi_value theBuffer;
+  char* theCopy;
   NODE_API_CALL(env,
-      napi_create_buffer_copy(env, sizeof(theText), theText, NULL, &theBuffer));
+      napi_create_buffer_copy(
+          env, sizeof(theText), theText, (void**)(&theCopy), &theBuffer));
+  NODE_API_ASSERT(env,
+      theCopy && !strcmp(theCopy, theText),
+      "Failed to return the data of the copy");
   return theBuffer;
 }
 
@@ -156,6 +174,7 @@ static napi_value Init(napi_env env, napi_value exports) {
 
   napi_property_descriptor methods[] = {
       DECLARE_NODE_API_PROPERTY("newBuffer", newBuffer),
+      DECLARE_NODE_API_PROPERTY("newBufferOfLength", newBufferOfLength),
       DECLARE_NODE_API_PROPERTY("newExternalBuffer", newExternalBuffer),
       DECLARE_NODE_API_PROPERTY("getDeleterCallCount", getDeleterCallCount),
       DECLARE_NODE_API_PROPERTY("copyBuffer", copyBuffer),
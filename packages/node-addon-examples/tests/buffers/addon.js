@@ -20,6 +20,37 @@ module.exports = () => {
   assert.strictEqual(addon.bufferInfo(buffer), true);
   addon.invalidObjectAsBuffer({});
 
+  // Small buffers are slices of a shared pool, reported with their own length
+  assert.strictEqual(addon.bufferInfo(addon.newBuffer()), true);
+  assert.strictEqual(addon.bufferInfo(addon.copyBuffer()), true);
+  assert.strictEqual(addon.bufferInfo(addon.newExternalBuffer()), true);
+
+  // Without a global Buffer, small buffers are slices of a shared pool,
+  // aligned for any typed array to view them
+  const hasGlobalBuffer = typeof Buffer === "function";
+  const first = addon.newBufferOfLength(3);
+  const second = addon.newBufferOfLength(5);
+  if (!hasGlobalBuffer) {
+    assert.strictEqual(first.buffer, second.buffer);
+    assert.strictEqual(first.byteOffset % 8, 0);
+    assert.strictEqual(second.byteOffset % 8, 0);
+    assert.notStrictEqual(first.byteOffset, second.byteOffset);
+  }
+  assert.strictEqual(first.length, 3);
+  assert.strictEqual(second.length, 5);
+
+  // Buffers of half the pool size or more aren't pooled
+  const large = addon.newBufferOfLength(4096);
+  assert.strictEqual(large.byteOffset, 0);
+  assert.strictEqual(large.buffer.byteLength, 4096);
+
+  // Buffers are Uint8Arrays, with the prototype of a global Buffer if any
+  assert(first instanceof Uint8Array);
+  assert.strictEqual(
+    Object.getPrototypeOf(first),
+    hasGlobalBuffer ? Buffer.prototype : Uint8Array.prototype,
+  );
+
   // TODO: Add gc tests
   // @see
   // https://github.com/callstackincubator/react-native-node-api/issues/182
@@ -0,0 +1,160 @@
+#include <node_api.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif _POSIX_C_SOURCE >= 199309L
+#include <time.h>  // for nanosleep
+#else
+#include <unistd.h>  // for usleep
+#endif
+
+void sleep_ms(int milliseconds) {  // cross-platform sleep function
+#ifdef WIN32
+  Sleep(milliseconds);
+#elif _POSIX_C_SOURCE >= 199309L
+  struct timespec ts;
+  ts.tv_sec = milliseconds / 1000;
+  ts.tv_nsec = (milliseconds % 1000) * 1000000;
+  nanosleep(&ts, NULL);
+#else
+  if (milliseconds >= 1000) sleep(milliseconds / 1000);
+  usleep((milliseconds % 1000) * 1000);
+#endif
+}
+
+// Matches the default size of the libuv threadpool, which the host never
+// goes below
+#define JOB_COUNT 4
+#define TIMEOUT_MS 5000
+
+typedef struct {
+  napi_async_work _request;
+  bool _saw_siblings;
+  bool _saw_release;
+} job;
+
+static job jobs[JOB_COUNT];
+static atomic_int arrived;
+static atomic_bool released;
+static int completed;
+static napi_ref callback_ref;
+
+// Polls the predicate until it holds or the timeout is reached
+static bool wait_for(bool (*predicate)(void)) {
+  for (int elapsed = 0; elapsed < TIMEOUT_MS; elapsed++) {
+    if (predicate()) {
+      return true;
+    }
+    sleep_ms(1);
+  }
+  return predicate();
+}
+
+static bool all_arrived(void) {
+  return atomic_load(&arrived) == JOB_COUNT;
+}
+
+static bool is_released(void) {
+  return atomic_load(&released);
+}
+
+static void Execute(napi_env env, void* data) {
+  job* j = (job*)data;
+  atomic_fetch_add(&arrived, 1);
+  // Only succeeds if every job is executing at the same time
+  j->_saw_siblings = wait_for(all_arrived);
+  // Only succeeds if the JS thread is free to call "release" meanwhile
+  j->_saw_release = wait_for(is_released);
+}
+
+static void Complete(napi_env env, napi_status status, void* data) {
+  job* j = (job*)data;
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, j->_request));
+  j->_request = NULL;
+
+  if (++completed < JOB_COUNT) {
+    return;
+  }
+
+  int concurrent = 0;
+  int unblocked = 0;
+  for (int i = 0; i < JOB_COUNT; i++) {
+    concurrent += jobs[i]._saw_siblings;
+    unblocked += jobs[i]._saw_release;
+  }
+
+  napi_value argv[2];
+  NODE_API_CALL_RETURN_VOID(env, napi_create_int32(env, concurrent, &argv[0]));
+  NODE_API_CALL_RETURN_VOID(env, napi_create_int32(env, unblocked, &argv[1]));
+  napi_value callback;
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_get_reference_value(env, callback_ref, &callback));
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_reference(env, callback_ref));
+  callback_ref = NULL;
+  napi_value global;
+  NODE_API_CALL_RETURN_VOID(env, napi_get_global(env, &global));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_call_function(env, global, callback, 2, argv, NULL));
+}
+
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value callback;
+  napi_value resource_name;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, &callback, NULL, NULL));
+  NODE_API_ASSERT(env, argc >= 1, "Not enough arguments, expected 1.");
+  NODE_API_ASSERT(env, callback_ref == NULL, "Already running.");
+
+  atomic_store(&arrived, 0);
+  atomic_store(&released, false);
+  completed = 0;
+  NODE_API_CALL(env, napi_create_reference(env, callback, 1, &callback_ref));
+  NODE_API_CALL(env,
+      napi_create_string_utf8(
+          env, "ConcurrencyResource", NAPI_AUTO_LENGTH, &resource_name));
+
+  for (int i = 0; i < JOB_COUNT; i++) {
+    jobs[i]._saw_siblings = false;
+    jobs[i]._saw_release = false;
+    NODE_API_CALL(env,
+        napi_create_async_work(env,
+            NULL,
+            resource_name,
+            Execute,
+            Complete,
+            &jobs[i],
+            &jobs[i]._request));
+    NODE_API_CALL(env, napi_queue_async_work(env, jobs[i]._request));
+  }
+
+  return NULL;
+}
+
+static napi_value Release(napi_env env, napi_callback_info info) {
+  atomic_store(&released, true);
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value job_count;
+  NODE_API_CALL(env, napi_create_int32(env, JOB_COUNT, &job_count));
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY("release", Release),
+      DECLARE_NODE_API_PROPERTY_VALUE("jobCount", job_count),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
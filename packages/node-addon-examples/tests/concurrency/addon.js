@@ -0,0 +1,21 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+module.exports = () =>
+  new Promise((resolve, reject) => {
+    addon.run((concurrent, unblocked) => {
+      try {
+        // Every job waited for all of its siblings to start executing
+        assert.strictEqual(concurrent, addon.jobCount);
+        // Every job waited for the JS thread to call "release"
+        assert.strictEqual(unblocked, addon.jobCount);
+        resolve();
+      } catch (e) {
+        reject(e);
+      }
+    });
+    // Would never run before the jobs time out, if they executed on this thread
+    setTimeout(() => addon.release(), 10);
+  });
@@ -0,0 +1,91 @@
+#include <node_api.h>
+#include <node_api_host.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+typedef struct {
+  uint32_t id;
+  const char* name;
+  double amount;
+  bool active;
+  int64_t balance;
+} Coin;
+
+static const Coin coins[] = {
+    {1, "Bitcoin", 0.5, true, 9007199254740993},
+    {2, "Ether", 12.25, false, -42},
+    {3, NULL, 0, true, 0},
+};
+
+static const node_api_host_field coinFields[] = {
+    {"id", node_api_host_field_uint32, offsetof(Coin, id)},
+    {"name", node_api_host_field_string, offsetof(Coin, name)},
+    {"amount", node_api_host_field_double, offsetof(Coin, amount)},
+    {"active", node_api_host_field_bool, offsetof(Coin, active)},
+    {"balance", node_api_host_field_bigint64, offsetof(Coin, balance)},
+};
+
+static napi_value createCoins(napi_env env, napi_callback_info info) {
+  napi_value result;
+  NODE_API_CALL(env,
+      node_api_host_create_object_array(env,
+          coinFields,
+          sizeof(coinFields) / sizeof(coinFields[0]),
+          coins,
+          sizeof(Coin),
+          sizeof(coins) / sizeof(coins[0]),
+          &result));
+  return result;
+}
+
+// Creates more records than fit a single handle scope of the host
+static napi_value createManyCoins(napi_env env, napi_callback_info info) {
+  static Coin records[1000];
+  for (uint32_t i = 0; i < 1000; i++) {
+    records[i] = (Coin){i, "Coin", i * 0.5, i % 2 == 0, -(int64_t)i};
+  }
+
+  napi_value result;
+  NODE_API_CALL(env,
+      node_api_host_create_object_array(env,
+          coinFields,
+          sizeof(coinFields) / sizeof(coinFields[0]),
+          records,
+          sizeof(Coin),
+          1000,
+          &result));
+  return result;
+}
+
+static napi_value fieldOutOfBounds(napi_env env, napi_callback_info info) {
+  const node_api_host_field fields[] = {
+      {"id", node_api_host_field_int64, sizeof(Coin)},
+  };
+  napi_value result;
+  const napi_status status = node_api_host_create_object_array(
+      env, fields, 1, coins, sizeof(Coin), 1, &result);
+
+  napi_value isInvalid;
+  NODE_API_CALL(
+      env, napi_get_boolean(env, status == napi_invalid_arg, &isInvalid));
+  return isInvalid;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor methods[] = {
+      DECLARE_NODE_API_PROPERTY("createCoins", createCoins),
+      DECLARE_NODE_API_PROPERTY("createManyCoins", createManyCoins),
+      DECLARE_NODE_API_PROPERTY("fieldOutOfBounds", fieldOutOfBounds),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(methods) / sizeof(methods[0]), methods));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
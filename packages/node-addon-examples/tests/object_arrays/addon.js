@@ -0,0 +1,37 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+module.exports = () => {
+  assert.deepStrictEqual(addon.createCoins(), [
+    {
+      id: 1,
+      name: "Bitcoin",
+      amount: 0.5,
+      active: true,
+      balance: 9007199254740993n,
+    },
+    { id: 2, name: "Ether", amount: 12.25, active: false, balance: -42n },
+    { id: 3, name: null, amount: 0, active: true, balance: 0n },
+  ]);
+
+  const coins = addon.createManyCoins();
+  assert.strictEqual(coins.length, 1000);
+  assert.deepStrictEqual(coins[999], {
+    id: 999,
+    name: "Coin",
+    amount: 499.5,
+    active: false,
+    balance: -999n,
+  });
+  assert.deepStrictEqual(Object.keys(coins[500]), [
+    "id",
+    "name",
+    "amount",
+    "active",
+    "balance",
+  ]);
+
+  assert.strictEqual(addon.fieldOutOfBounds(), true);
+};
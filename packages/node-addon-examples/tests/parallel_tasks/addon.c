@@ -0,0 +1,136 @@
+#include <node_api.h>
+#include <node_api_host.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+#define LOOP_COUNT 10000
+#define TASK_COUNT 64
+
+typedef struct {
+  napi_async_work _request;
+  napi_ref _callback;
+  size_t _thread_count;
+  // Set by the loop, index * index for every index
+  int64_t _squares[LOOP_COUNT];
+  // The number of top level and nested tasks which ran
+  int _tasks_run;
+  int _nested_tasks_run;
+} state;
+
+static void Square(void* data, size_t index) {
+  state* s = (state*)data;
+  s->_squares[index] = (int64_t)index * (int64_t)index;
+}
+
+static void NestedTask(void* data) {
+  state* s = (state*)data;
+  __atomic_fetch_add(&s->_nested_tasks_run, 1, __ATOMIC_SEQ_CST);
+}
+
+static void Task(void* data) {
+  state* s = (state*)data;
+  // Submitted from a task, to be run by the same thread unless stolen
+  if (node_api_host_submit(node_api_host_priority_default, NestedTask, s) !=
+      napi_ok) {
+    return;
+  }
+  __atomic_fetch_add(&s->_tasks_run, 1, __ATOMIC_SEQ_CST);
+}
+
+static void Execute(napi_env env, void* data) {
+  state* s = (state*)data;
+  // Run from a thread of the host, which takes part in the loop
+  if (node_api_host_parallel_for(LOOP_COUNT, Square, s) != napi_ok) {
+    return;
+  }
+  for (int i = 0; i < TASK_COUNT; i++) {
+    if (node_api_host_submit(node_api_host_priority_background, Task, s) !=
+        napi_ok) {
+      return;
+    }
+  }
+  // Waits for the tasks, which other threads steal while this one is busy
+  while (__atomic_load_n(&s->_nested_tasks_run, __ATOMIC_SEQ_CST) <
+         TASK_COUNT) {
+  }
+}
+
+static void Complete(napi_env env, napi_status status, void* data) {
+  state* s = (state*)data;
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, s->_request));
+
+  int64_t sum = 0;
+  int64_t expected_sum = 0;
+  for (int64_t i = 0; i < LOOP_COUNT; i++) {
+    sum += s->_squares[i];
+    expected_sum += i * i;
+  }
+
+  napi_value callback, global, result, value;
+  NODE_API_CALL_RETURN_VOID(env, napi_create_object(env, &result));
+  NODE_API_CALL_RETURN_VOID(env, napi_get_boolean(env, sum == expected_sum, &value));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_set_named_property(env, result, "loopCompleted", value));
+  NODE_API_CALL_RETURN_VOID(env, napi_create_int32(env, s->_tasks_run, &value));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_set_named_property(env, result, "tasksRun", value));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_create_int32(env, s->_nested_tasks_run, &value));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_set_named_property(env, result, "nestedTasksRun", value));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_create_uint32(env, (uint32_t)s->_thread_count, &value));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_set_named_property(env, result, "threadCount", value));
+
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_get_reference_value(env, s->_callback, &callback));
+  NODE_API_CALL_RETURN_VOID(env, napi_get_global(env, &global));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_call_function(env, global, callback, 1, &result, NULL));
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_reference(env, s->_callback));
+  free(s);
+}
+
+static napi_value Run(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 1, "Expected a callback");
+
+  state* s = (state*)calloc(1, sizeof(state));
+  NODE_API_ASSERT(env, s != NULL, "Failed to allocate the state");
+  NODE_API_CALL(env, node_api_host_get_thread_count(&s->_thread_count));
+  NODE_API_CALL(env, napi_create_reference(env, argv[0], 1, &s->_callback));
+
+  napi_value name;
+  NODE_API_CALL(env,
+                napi_create_string_utf8(
+                    env, "TestResource", NAPI_AUTO_LENGTH, &name));
+  NODE_API_CALL(env,
+                napi_create_async_work(
+                    env, NULL, name, Execute, Complete, s, &s->_request));
+  NODE_API_CALL(env, napi_queue_async_work(env, s->_request));
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value taskCount;
+  NODE_API_CALL(env, napi_create_int32(env, TASK_COUNT, &taskCount));
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("run", Run),
+      DECLARE_NODE_API_PROPERTY_VALUE("taskCount", taskCount),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(properties[0]), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,15 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+module.exports = async () => {
+  const result = await new Promise((resolve) => addon.run(resolve));
+
+  assert(result.threadCount >= 4);
+  // Every index of the loop was visited
+  assert(result.loopCompleted);
+  // Every task ran, along with the task it submitted
+  assert.strictEqual(result.tasksRun, addon.taskCount);
+  assert.strictEqual(result.nestedTasksRun, addon.taskCount);
+};
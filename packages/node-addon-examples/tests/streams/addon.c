@@ -0,0 +1,129 @@
+#include <node_api.h>
+#include <node_api_host.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif _POSIX_C_SOURCE >= 199309L
+#include <time.h>  // for nanosleep
+#else
+#include <unistd.h>  // for usleep
+#endif
+
+void sleep_ms(int milliseconds) {  // cross-platform sleep function
+#ifdef WIN32
+  Sleep(milliseconds);
+#elif _POSIX_C_SOURCE >= 199309L
+  struct timespec ts;
+  ts.tv_sec = milliseconds / 1000;
+  ts.tv_nsec = (milliseconds % 1000) * 1000000;
+  nanosleep(&ts, NULL);
+#else
+  if (milliseconds >= 1000) sleep(milliseconds / 1000);
+  usleep((milliseconds % 1000) * 1000);
+#endif
+}
+
+// Many more elements than the stream holds, written in small chunks
+#define ELEMENT_COUNT 10000
+#define STREAM_CAPACITY 256
+#define CHUNK_SIZE 16
+
+typedef struct {
+  node_api_host_stream _stream;
+  napi_async_work _request;
+} producer;
+
+// Writes the elements from a thread of the host, waiting for JS to read them
+// whenever the stream is full
+static void Produce(napi_env env, void* data) {
+  producer* p = (producer*)data;
+  float chunk[CHUNK_SIZE];
+  size_t produced = 0;
+  while (produced < ELEMENT_COUNT) {
+    size_t count = 0;
+    while (count < CHUNK_SIZE && produced + count < ELEMENT_COUNT) {
+      chunk[count] = (float)(produced + count);
+      count++;
+    }
+    size_t offset = 0;
+    while (offset < count) {
+      size_t written = 0;
+      NODE_API_BASIC_ASSERT_RETURN_VOID(
+          node_api_host_stream_write(
+              p->_stream, chunk + offset, count - offset, &written) == napi_ok,
+          "Failed to write to the stream");
+      offset += written;
+      if (offset < count) {
+        sleep_ms(1);
+      }
+    }
+    produced += count;
+  }
+}
+
+static void Done(napi_env env, napi_status status, void* data) {
+  producer* p = (producer*)data;
+  NODE_API_CALL_RETURN_VOID(env, node_api_host_release_stream(p->_stream));
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, p->_request));
+  free(p);
+}
+
+static napi_value Start(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value callback;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, &callback, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 1, "Expected a callback");
+
+  producer* p = (producer*)malloc(sizeof(producer));
+  NODE_API_ASSERT(env, p != NULL, "Failed to allocate the producer");
+  NODE_API_CALL(env,
+      node_api_host_create_stream(
+          env, napi_float32_array, STREAM_CAPACITY, callback, &p->_stream));
+
+  napi_value name;
+  NODE_API_CALL(env,
+      napi_create_string_utf8(env, "Produce", NAPI_AUTO_LENGTH, &name));
+  NODE_API_CALL(env,
+      napi_create_async_work(env, NULL, name, Produce, Done, p, &p->_request));
+  NODE_API_CALL(env, napi_queue_async_work(env, p->_request));
+  return NULL;
+}
+
+static napi_value InvalidCapacity(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value callback;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, &callback, NULL, NULL));
+
+  node_api_host_stream stream;
+  const napi_status status = node_api_host_create_stream(
+      env, napi_float32_array, 0, callback, &stream);
+
+  napi_value isInvalid;
+  NODE_API_CALL(
+      env, napi_get_boolean(env, status == napi_invalid_arg, &isInvalid));
+  return isInvalid;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value elementCount, streamCapacity;
+  NODE_API_CALL(env, napi_create_int32(env, ELEMENT_COUNT, &elementCount));
+  NODE_API_CALL(env, napi_create_int32(env, STREAM_CAPACITY, &streamCapacity));
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("start", Start),
+      DECLARE_NODE_API_PROPERTY("invalidCapacity", InvalidCapacity),
+      DECLARE_NODE_API_PROPERTY_VALUE("elementCount", elementCount),
+      DECLARE_NODE_API_PROPERTY_VALUE("streamCapacity", streamCapacity),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(properties[0]), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,34 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+const consume = () =>
+  new Promise((resolve) => {
+    const received = [];
+    const views = new Set();
+    addon.start((view, offset, count) => {
+      views.add(view);
+      for (let i = 0; i < count; i++) {
+        received.push(view[(offset + i) % view.length]);
+      }
+      if (received.length === addon.elementCount) {
+        resolve({ received, views });
+      }
+    });
+  });
+
+module.exports = async () => {
+  const { received, views } = await consume();
+  assert.deepStrictEqual(
+    received,
+    Array.from({ length: addon.elementCount }, (_, i) => i),
+  );
+  // Every call passes the same view over the entire stream
+  assert.strictEqual(views.size, 1);
+  const [view] = views;
+  assert(view instanceof Float32Array);
+  assert.strictEqual(view.length, addon.streamCapacity);
+
+  assert.strictEqual(addon.invalidCapacity(() => {}), true);
+};
@@ -0,0 +1,60 @@
+#include <node_api.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+// Arguments: description
+static napi_value SymbolFor(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 1, "Expected a description.");
+
+  char description[64];
+  size_t length;
+  NODE_API_CALL(env,
+      napi_get_value_string_utf8(
+          env, argv[0], description, sizeof(description), &length));
+
+  napi_value result;
+  NODE_API_CALL(env, node_api_symbol_for(env, description, length, &result));
+  return result;
+}
+
+// Arguments: code, message
+static napi_value CreateSyntaxError(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc == 2, "Expected a code and a message.");
+
+  napi_valuetype code_type;
+  NODE_API_CALL(env, napi_typeof(env, argv[0], &code_type));
+  napi_value code = code_type == napi_undefined ? NULL : argv[0];
+
+  napi_value result;
+  NODE_API_CALL(
+      env, node_api_create_syntax_error(env, code, argv[1], &result));
+  return result;
+}
+
+static napi_value ThrowSyntaxError(napi_env env, napi_callback_info info) {
+  NODE_API_CALL(env,
+      node_api_throw_syntax_error(
+          env, "ERR_TEST", "Syntax error thrown by the addon"));
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("symbolFor", SymbolFor),
+      DECLARE_NODE_API_PROPERTY("createSyntaxError", CreateSyntaxError),
+      DECLARE_NODE_API_PROPERTY("throwSyntaxError", ThrowSyntaxError),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,46 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+const testSymbolFor = () => {
+  // Symbols are looked up in the global registry
+  assert.strictEqual(
+    addon.symbolFor("react-native"),
+    Symbol.for("react-native"),
+  );
+  assert.strictEqual(addon.symbolFor(""), Symbol.for(""));
+  assert.notStrictEqual(addon.symbolFor("a"), addon.symbolFor("b"));
+};
+
+const testCreateSyntaxError = () => {
+  const error = addon.createSyntaxError("ERR_TEST", "Created by the addon");
+  assert(error instanceof SyntaxError);
+  assert.strictEqual(error.message, "Created by the addon");
+  assert.strictEqual(error.code, "ERR_TEST");
+
+  const withoutCode = addon.createSyntaxError(undefined, "Without code");
+  assert(withoutCode instanceof SyntaxError);
+  assert.strictEqual(withoutCode.code, undefined);
+
+  // Like napi_create_error, the message must be a string
+  assert.throws(() => addon.createSyntaxError("ERR_TEST", 42), Error);
+};
+
+const testThrowSyntaxError = () => {
+  try {
+    addon.throwSyntaxError();
+  } catch (error) {
+    assert(error instanceof SyntaxError);
+    assert.strictEqual(error.message, "Syntax error thrown by the addon");
+    assert.strictEqual(error.code, "ERR_TEST");
+    return;
+  }
+  assert.fail("Expected a syntax error");
+};
+
+module.exports = () => {
+  testSymbolFor();
+  testCreateSyntaxError();
+  testThrowSyntaxError();
+};
@@ -0,0 +1,224 @@
+#include <node_api.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif _POSIX_C_SOURCE >= 199309L
+#include <time.h>  // for nanosleep
+#else
+#include <unistd.h>  // for usleep
+#endif
+
+void sleep_ms(int milliseconds) {  // cross-platform sleep function
+#ifdef WIN32
+  Sleep(milliseconds);
+#elif _POSIX_C_SOURCE >= 199309L
+  struct timespec ts;
+  ts.tv_sec = milliseconds / 1000;
+  ts.tv_nsec = (milliseconds % 1000) * 1000000;
+  nanosleep(&ts, NULL);
+#else
+  if (milliseconds >= 1000) sleep(milliseconds / 1000);
+  usleep((milliseconds % 1000) * 1000);
+#endif
+}
+
+// More than the host's lock-free ring holds when the queue is unlimited
+#define CALL_COUNT 2000
+
+typedef struct {
+  napi_threadsafe_function _tsfn;
+  napi_async_work _request;
+  napi_threadsafe_function_call_mode _mode;
+  int _abort_after;
+  int _queue_full;
+  // Both the async work and the threadsafe function must finish
+  int _pending;
+  napi_ref _on_done;
+} producer;
+
+static producer the_producer;
+static int values[CALL_COUNT];
+
+static void CallJs(napi_env env, napi_value js_cb, void* context, void* data) {
+  if (env == NULL) {
+    // The function was aborted before this call could be dispatched
+    return;
+  }
+
+  napi_value argv[1];
+  napi_value undefined;
+  NODE_API_CALL_RETURN_VOID(env, napi_create_int32(env, *(int*)data, argv));
+  NODE_API_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_call_function(env, undefined, js_cb, 1, argv, NULL));
+}
+
+// Runs on a worker thread, producing calls as fast as possible
+static void Produce(napi_env env, void* data) {
+  producer* p = (producer*)data;
+  for (int i = 0; i < CALL_COUNT; i++) {
+    napi_status status;
+    while ((status = napi_call_threadsafe_function(
+                p->_tsfn, &values[i], p->_mode)) == napi_queue_full) {
+      p->_queue_full++;
+      sleep_ms(1);
+    }
+    NODE_API_BASIC_ASSERT_RETURN_VOID(
+        status == napi_ok, "Expected the call to succeed");
+    if (i + 1 == p->_abort_after) {
+      NODE_API_BASIC_ASSERT_RETURN_VOID(
+          napi_release_threadsafe_function(p->_tsfn, napi_tsfn_abort) ==
+              napi_ok,
+          "Expected abort to succeed");
+      return;
+    }
+  }
+  NODE_API_BASIC_ASSERT_RETURN_VOID(
+      napi_release_threadsafe_function(p->_tsfn, napi_tsfn_release) == napi_ok,
+      "Expected release to succeed");
+}
+
+static void Done(napi_env env, producer* p) {
+  if (--p->_pending > 0) {
+    return;
+  }
+  napi_value argv[1];
+  NODE_API_CALL_RETURN_VOID(env, napi_create_int32(env, p->_queue_full, argv));
+  napi_value on_done;
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_get_reference_value(env, p->_on_done, &on_done));
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_reference(env, p->_on_done));
+  p->_on_done = NULL;
+  napi_value undefined;
+  NODE_API_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NODE_API_CALL_RETURN_VOID(
+      env, napi_call_function(env, undefined, on_done, 1, argv, NULL));
+}
+
+static void ProduceComplete(napi_env env, napi_status status, void* data) {
+  producer* p = (producer*)data;
+  NODE_API_CALL_RETURN_VOID(env, napi_delete_async_work(env, p->_request));
+  p->_request = NULL;
+  Done(env, p);
+}
+
+static void Finalize(napi_env env, void* data, void* context) {
+  Done(env, (producer*)context);
+}
+
+// Arguments: onCall, onDone, maxQueueSize, blocking, abortAfter
+static napi_value Start(napi_env env, napi_callback_info info) {
+  size_t argc = 5;
+  napi_value argv[5];
+  NODE_API_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NODE_API_ASSERT(env, argc >= 5, "Not enough arguments, expected 5.");
+  NODE_API_ASSERT(env, the_producer._on_done == NULL, "Already running.");
+
+  uint32_t max_queue_size;
+  bool blocking;
+  int32_t abort_after;
+  NODE_API_CALL(env, napi_get_value_uint32(env, argv[2], &max_queue_size));
+  NODE_API_CALL(env, napi_get_value_bool(env, argv[3], &blocking));
+  NODE_API_CALL(env, napi_get_value_int32(env, argv[4], &abort_after));
+
+  the_producer._mode =
+      blocking ? napi_tsfn_blocking : napi_tsfn_nonblocking;
+  the_producer._abort_after = abort_after;
+  the_producer._queue_full = 0;
+  the_producer._pending = 2;
+  for (int i = 0; i < CALL_COUNT; i++) {
+    values[i] = i;
+  }
+
+  napi_value resource_name;
+  NODE_API_CALL(env,
+      napi_create_string_utf8(
+          env, "ThreadsafeFunctionResource", NAPI_AUTO_LENGTH, &resource_name));
+  NODE_API_CALL(
+      env, napi_create_reference(env, argv[1], 1, &the_producer._on_done));
+  NODE_API_CALL(env,
+      napi_create_threadsafe_function(env,
+          argv[0],
+          NULL,
+          resource_name,
+          max_queue_size,
+          1,
+          NULL,
+          Finalize,
+          &the_producer,
+          CallJs,
+          &the_producer._tsfn));
+
+  void* context;
+  NODE_API_CALL(env,
+      napi_get_threadsafe_function_context(the_producer._tsfn, &context));
+  NODE_API_ASSERT(env, context == &the_producer, "Unexpected context.");
+
+  NODE_API_CALL(env,
+      napi_create_async_work(env,
+          NULL,
+          resource_name,
+          Produce,
+          ProduceComplete,
+          &the_producer,
+          &the_producer._request));
+  NODE_API_CALL(env, napi_queue_async_work(env, the_producer._request));
+  return NULL;
+}
+
+static void IgnoreCall(
+    napi_env env, napi_value js_cb, void* context, void* data) {}
+
+// Returns whether a blocking call from the JS thread on a full queue, which
+// only the JS thread could make room in, fails instead of waiting forever
+static napi_value CallBlockingWhenFull(napi_env env, napi_callback_info info) {
+  napi_value resource_name;
+  NODE_API_CALL(env,
+      napi_create_string_utf8(
+          env, "ThreadsafeFunctionResource", NAPI_AUTO_LENGTH, &resource_name));
+  napi_threadsafe_function tsfn;
+  NODE_API_CALL(env,
+      napi_create_threadsafe_function(env,
+          NULL,
+          NULL,
+          resource_name,
+          1,
+          1,
+          NULL,
+          NULL,
+          NULL,
+          IgnoreCall,
+          &tsfn));
+  NODE_API_CALL(
+      env, napi_call_threadsafe_function(tsfn, NULL, napi_tsfn_blocking));
+  const napi_status status =
+      napi_call_threadsafe_function(tsfn, NULL, napi_tsfn_blocking);
+  NODE_API_CALL(env, napi_release_threadsafe_function(tsfn, napi_tsfn_abort));
+
+  napi_value result;
+  NODE_API_CALL(
+      env, napi_get_boolean(env, status == napi_would_deadlock, &result));
+  return result;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value call_count;
+  NODE_API_CALL(env, napi_create_int32(env, CALL_COUNT, &call_count));
+
+  napi_property_descriptor properties[] = {
+      DECLARE_NODE_API_PROPERTY("start", Start),
+      DECLARE_NODE_API_PROPERTY("callBlockingWhenFull", CallBlockingWhenFull),
+      DECLARE_NODE_API_PROPERTY_VALUE("callCount", call_count),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(properties) / sizeof(*properties), properties));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,66 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+const produce = ({ maxQueueSize, blocking, abortAfter = 0 }) =>
+  new Promise((resolve) => {
+    const received = [];
+    addon.start(
+      (value) => received.push(value),
+      (queueFull) => resolve({ received, queueFull }),
+      maxQueueSize,
+      blocking,
+      abortAfter,
+    );
+  });
+
+const expectedValues = Array.from({ length: addon.callCount }, (_, i) => i);
+
+const testBlocking = async () => {
+  const { received, queueFull } = await produce({
+    maxQueueSize: 1,
+    blocking: true,
+  });
+  assert.deepStrictEqual(received, expectedValues);
+  assert.strictEqual(queueFull, 0);
+};
+
+const testNonBlocking = async () => {
+  const { received } = await produce({ maxQueueSize: 4, blocking: false });
+  // The producer retries calls rejected with napi_queue_full
+  assert.deepStrictEqual(received, expectedValues);
+};
+
+const testUnlimited = async () => {
+  const { received, queueFull } = await produce({
+    maxQueueSize: 0,
+    blocking: false,
+  });
+  assert.deepStrictEqual(received, expectedValues);
+  assert.strictEqual(queueFull, 0);
+};
+
+const testAbort = async () => {
+  const abortAfter = 10;
+  const { received } = await produce({
+    maxQueueSize: 0,
+    blocking: false,
+    abortAfter,
+  });
+  // Calls still queued when aborting are dropped
+  assert(received.length <= abortAfter);
+  assert.deepStrictEqual(received, expectedValues.slice(0, received.length));
+};
+
+const testWouldDeadlock = () => {
+  assert.strictEqual(addon.callBlockingWhenFull(), true);
+};
+
+module.exports = async () => {
+  await testBlocking();
+  await testNonBlocking();
+  await testUnlimited();
+  await testAbort();
+  testWouldDeadlock();
+};
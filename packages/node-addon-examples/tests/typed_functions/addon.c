@@ -0,0 +1,135 @@
+#include <node_api.h>
+#include <node_api_host.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../RuntimeNodeApiTestsCommon.h"
+
+static void multiplyAdd(
+    void* data, const node_api_host_value* args, node_api_host_value* result) {
+  result->number = args[0].int32 * args[1].number + *(const double*)data;
+}
+
+// Sums the bytes of the buffer, counting only odd bytes if asked to
+static void sumBytes(
+    void* data, const node_api_host_value* args, node_api_host_value* result) {
+  const uint8_t* bytes = args[0].buffer.data;
+  uint32_t sum = 0;
+  for (size_t i = 0; i < args[0].buffer.byte_length; i++) {
+    if (!args[1].boolean || bytes[i] % 2 == 1) {
+      sum += bytes[i];
+    }
+  }
+  result->uint32 = sum;
+}
+
+static void negate(
+    void* data, const node_api_host_value* args, node_api_host_value* result) {
+  result->int64 = -args[0].int64;
+}
+
+static void count(
+    void* data, const node_api_host_value* args, node_api_host_value* result) {
+  (*(uint32_t*)data)++;
+}
+
+static napi_value createFunction(napi_env env,
+    const char* name,
+    const node_api_host_type* arg_types,
+    size_t arg_count,
+    node_api_host_type result_type,
+    node_api_host_typed_callback cb,
+    void* data) {
+  napi_value result;
+  NODE_API_CALL(env,
+      node_api_host_create_typed_function(env,
+          name,
+          NAPI_AUTO_LENGTH,
+          arg_types,
+          arg_count,
+          result_type,
+          cb,
+          data,
+          &result));
+  return result;
+}
+
+static napi_value getCount(napi_env env, napi_callback_info info) {
+  void* data;
+  NODE_API_CALL(env, napi_get_cb_info(env, info, NULL, NULL, NULL, &data));
+  napi_value result;
+  NODE_API_CALL(env, napi_create_uint32(env, *(uint32_t*)data, &result));
+  return result;
+}
+
+static napi_value tooManyArguments(napi_env env, napi_callback_info info) {
+  node_api_host_type types[NODE_API_HOST_TYPED_FUNCTION_MAX_ARGS + 1];
+  for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    types[i] = node_api_host_type_int32;
+  }
+  napi_value result;
+  const napi_status status = node_api_host_create_typed_function(env,
+      "tooMany",
+      NAPI_AUTO_LENGTH,
+      types,
+      sizeof(types) / sizeof(types[0]),
+      node_api_host_type_void,
+      count,
+      NULL,
+      &result);
+
+  napi_value isInvalid;
+  NODE_API_CALL(
+      env, napi_get_boolean(env, status == napi_invalid_arg, &isInvalid));
+  return isInvalid;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  static const double offset = 0.5;
+  static uint32_t calls = 0;
+  static const node_api_host_type multiplyAddArgs[] = {
+      node_api_host_type_int32, node_api_host_type_double};
+  static const node_api_host_type sumBytesArgs[] = {
+      node_api_host_type_buffer, node_api_host_type_bool};
+  static const node_api_host_type negateArgs[] = {node_api_host_type_int64};
+
+  napi_property_descriptor methods[] = {
+      DECLARE_NODE_API_PROPERTY_VALUE("multiplyAdd",
+          createFunction(env,
+              "multiplyAdd",
+              multiplyAddArgs,
+              2,
+              node_api_host_type_double,
+              multiplyAdd,
+              (void*)&offset)),
+      DECLARE_NODE_API_PROPERTY_VALUE("sumBytes",
+          createFunction(env,
+              "sumBytes",
+              sumBytesArgs,
+              2,
+              node_api_host_type_uint32,
+              sumBytes,
+              NULL)),
+      DECLARE_NODE_API_PROPERTY_VALUE("negate",
+          createFunction(env,
+              "negate",
+              negateArgs,
+              1,
+              node_api_host_type_int64,
+              negate,
+              NULL)),
+      DECLARE_NODE_API_PROPERTY_VALUE("count",
+          createFunction(
+              env, "count", NULL, 0, node_api_host_type_void, count, &calls)),
+      {"getCount", NULL, getCount, NULL, NULL, NULL, napi_default, &calls},
+      DECLARE_NODE_API_PROPERTY("tooManyArguments", tooManyArguments),
+  };
+
+  NODE_API_CALL(env,
+      napi_define_properties(
+          env, exports, sizeof(methods) / sizeof(methods[0]), methods));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,46 @@
+/* eslint-disable @typescript-eslint/no-require-imports */
+/* eslint-disable no-undef */
+const assert = require("assert");
+const addon = require("bindings")("addon.node");
+
+module.exports = () => {
+  assert.strictEqual(addon.multiplyAdd.name, "multiplyAdd");
+  assert.strictEqual(addon.multiplyAdd(3, 1.5), 5);
+  // Numbers are truncated into integer arguments
+  assert.strictEqual(addon.multiplyAdd(-2.9, 2), -3.5);
+  // Extra arguments are ignored
+  assert.strictEqual(addon.multiplyAdd(1, 1, "extra"), 1.5);
+
+  const bytes = new Uint8Array([1, 2, 3, 4, 5]);
+  assert.strictEqual(addon.sumBytes(bytes, false), 15);
+  assert.strictEqual(addon.sumBytes(bytes, true), 9);
+  assert.strictEqual(addon.sumBytes(bytes.subarray(1, 3), false), 5);
+  assert.strictEqual(addon.sumBytes(new Uint16Array([0x0101]), false), 2);
+  assert.strictEqual(addon.sumBytes(new DataView(bytes.buffer, 3), false), 9);
+  assert.strictEqual(addon.sumBytes(bytes.buffer, true), 9);
+
+  assert.strictEqual(addon.negate(2 ** 40), -(2 ** 40));
+
+  assert.strictEqual(addon.count(), undefined);
+  addon.count();
+  assert.strictEqual(addon.getCount(), 2);
+
+  assert.throws(() => addon.multiplyAdd(1), {
+    name: "TypeError",
+    message: "Expected argument 2 to be a number",
+  });
+  assert.throws(() => addon.multiplyAdd("1", 2), {
+    name: "TypeError",
+    message: "Expected argument 1 to be a number",
+  });
+  assert.throws(() => addon.sumBytes([1, 2], false), {
+    name: "TypeError",
+    message: "Expected argument 1 to be a typed array, DataView or ArrayBuffer",
+  });
+  assert.throws(() => addon.sumBytes(bytes, 1), {
+    name: "TypeError",
+    message: "Expected argument 2 to be a boolean",
+  });
+
+  assert.strictEqual(addon.tooManyArguments(), true);
+};